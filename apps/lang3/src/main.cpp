@@ -25,7 +25,11 @@ constexpr cli::Parser cli_parser() {
       .long_option("debug-ast-graph", "Output AST graph to a DOT file")
       .long_flag("debug-vm", "Debug the VM")
       .long_flag("debug-bytecode", "Debug the bytecode")
-      .long_flag("timings", "Show execution timings");
+      .long_flag("timings", "Show execution timings")
+      .long_flag("gc-stats", "Print garbage collector statistics at exit")
+      .long_option(
+          "isolates", "Run the program in N VMs at once, one thread each"
+      );
 }
 
 struct Debug {
@@ -36,6 +40,7 @@ struct Debug {
   bool vm = false;
   bool bytecode = false;
   bool timings = false;
+  bool gc_stats = false;
 };
 
 using namespace l3;
@@ -97,6 +102,44 @@ compile_ast(const ast::Program &program, const Debug &debug) {
   return program_bytecode;
 }
 
+// Runs one compiled program in `count` VMs on as many threads
+int run_isolates(
+    const bytecode::SharedProgram &program,
+    std::size_t count,
+    const Debug &debug
+) {
+  std::atomic<std::size_t> failures = 0;
+
+  const auto start_time = std::chrono::steady_clock::now();
+  {
+    std::vector<std::jthread> threads;
+    threads.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+      threads.emplace_back([&] {
+        vm::BytecodeVM vm{debug.vm};
+        try {
+          vm.execute(program);
+        } catch (runtime::RuntimeError &error) {
+          std::println(std::cerr, "{}", error.format_error());
+          ++failures;
+        }
+      });
+    }
+  }
+
+  if (debug.timings) {
+    auto end_time = std::chrono::steady_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        end_time - start_time
+    );
+    std::println(
+        std::cerr, "Executed {} isolates in {}ms", count, duration.count()
+    );
+  }
+
+  return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
 } // namespace
 
 int main(int argc, char *argv[]) {
@@ -119,6 +162,7 @@ int main(int argc, char *argv[]) {
       .vm = debug_flag || args->has_flag("debug-vm"),
       .bytecode = debug_flag || args->has_flag("debug-bytecode"),
       .timings = debug_flag || args->has_flag("timings"),
+      .gc_stats = args->has_flag("gc-stats"),
   };
 
   std::istream *input = &std::cin;
@@ -172,24 +216,47 @@ int main(int argc, char *argv[]) {
   if (!compiled) {
     return EXIT_FAILURE;
   }
-  auto &program_bytecode = *compiled;
-
   if (debug.bytecode) {
-    std::print(std::cerr, "{}", program_bytecode);
+    std::print(std::cerr, "{}", *compiled);
 
     if (!debug.vm) {
       return EXIT_SUCCESS;
     }
   }
 
+  const auto program_bytecode =
+      std::make_shared<const bytecode::ProgramBytecode>(std::move(*compiled));
+
+  if (const auto isolates = args->get_value("isolates")) {
+    std::size_t count = 0;
+    const auto [end, error] = std::from_chars(
+        isolates->data(), isolates->data() + isolates->size(), count
+    );
+    if (error != std::errc{} || end != isolates->data() + isolates->size() ||
+        count == 0) {
+      std::println(std::cerr, "Invalid number of isolates: {}", *isolates);
+      return EXIT_FAILURE;
+    }
+    return run_isolates(program_bytecode, count, debug);
+  }
+
   vm::BytecodeVM vm{debug.vm};
+  const auto print_gc_stats = [&] {
+    if (debug.gc_stats) {
+      std::println(std::cerr, "=== GC stats ===");
+      std::println(std::cerr, "{}", vm.get_gc_stats());
+    }
+  };
+
   const auto start_time = std::chrono::steady_clock::now();
   try {
     vm.execute(program_bytecode);
   } catch (runtime::RuntimeError &error) {
     std::println(std::cerr, "{}", error.format_error());
+    print_gc_stats();
     return EXIT_FAILURE;
   }
+  print_gc_stats();
 
   if (debug.timings) {
     auto end_time = std::chrono::steady_clock::now();
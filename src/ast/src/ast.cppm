@@ -13,6 +13,7 @@ export import :literal;
 export import :name_list;
 export import :operators;
 export import :range_for_loop;
+export import :record;
 export import :statement;
 export import :variable;
 export import :visitor;
@@ -56,6 +56,18 @@ public:
     }
   }
 
+  void visit(const Dict &node, OutputIterator &out) override {
+    format_indented_line(out, "Dict");
+    DepthGuard guard(depth);
+    for (const auto &[key, value] :
+         std::views::zip(node.get_keys(), node.get_values())) {
+      format_indented_line(out, "Entry");
+      DepthGuard entry_guard(depth);
+      visit(key, out);
+      visit(value, out);
+    }
+  }
+
   void visit(const NameList &node, OutputIterator &out) override {
     for (const auto &name : node) {
       visit(name, out);
@@ -100,6 +112,13 @@ public:
     visit(node.get_index(), out);
   }
 
+  void visit(const FieldExpression &node, OutputIterator &out) override {
+    format_indented_line(out, "FieldExpression");
+    DepthGuard guard(depth);
+    visit(node.get_base(), out);
+    visit(node.get_field(), out);
+  }
+
   void visit(const FunctionCall &node, OutputIterator &out) override {
     format_indented_line(out, "FunctionCall");
     DepthGuard guard(depth);
@@ -270,6 +289,10 @@ public:
     format_indented_line(out, "Number {}", node.get_value());
   }
 
+  void visit(const BigNumber &node, OutputIterator &out) override {
+    format_indented_line(out, "BigNumber {}", node.get_value());
+  }
+
   void visit(const Float &node, OutputIterator &out) override {
     format_indented_line(out, "Float {}", node.get_value());
   }
@@ -342,6 +365,15 @@ public:
     visit(node.get_variable(), out);
     visit(node.get_expression(), out);
   }
+
+  void visit(const RecordDeclaration &node, OutputIterator &out) override {
+    format_indented_line(out, "RecordDeclaration");
+    DepthGuard guard(depth);
+    visit(node.get_name(), out);
+    format_indented_line(out, "Fields");
+    DepthGuard fields_guard(depth);
+    visit(node.get_fields(), out);
+  }
 };
 
 } // namespace l3::ast
@@ -0,0 +1,17 @@
+module l3.ast;
+
+namespace l3::ast {
+
+Dict::Dict(location::Location location) : location_(location) {}
+Dict::Dict(
+    ExpressionList &&keys, ExpressionList &&values, location::Location location
+)
+    : keys(std::move(keys)), values(std::move(values)), location_(location) {}
+
+Dict &Dict::with_entry(Expression &&key, Expression &&value) {
+  keys.with_expression(std::move(key));
+  values.with_expression(std::move(value));
+  return *this;
+}
+
+} // namespace l3::ast
@@ -0,0 +1,31 @@
+export module l3.ast:dict;
+
+import l3.location;
+
+import :expression_list;
+
+export namespace l3::ast {
+
+// `{key: value, ...}`, keys and values are stored in order
+class Dict {
+  ExpressionList keys;
+  ExpressionList values;
+
+  DEFINE_LOCATION_FIELD()
+
+public:
+  Dict(location::Location location = {});
+  Dict(
+      ExpressionList &&keys,
+      ExpressionList &&values,
+      location::Location location = {}
+  );
+
+  // Prepends an entry, the grammar builds entry lists from the right
+  Dict &with_entry(Expression &&key, Expression &&value);
+
+  DEFINE_ACCESSOR_X(keys);
+  DEFINE_ACCESSOR_X(values);
+};
+
+} // namespace l3::ast
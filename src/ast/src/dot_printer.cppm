@@ -50,6 +50,18 @@ public:
     }
   }
 
+  void visit(const Dict &node, OutputIterator &out) override {
+    std::size_t id = get_next_id();
+    write_node(out, id, "Dict");
+    for (const auto &[key, value] :
+         std::views::zip(node.get_keys(), node.get_values())) {
+      write_edge_labeled(out, id, node_id, "key");
+      visit(key, out);
+      write_edge_labeled(out, id, node_id, "value");
+      visit(value, out);
+    }
+  }
+
   void visit(const NameList &node, OutputIterator &out) override {
     std::size_t id = get_next_id();
     write_node(out, id, "NameList");
@@ -108,6 +120,15 @@ public:
     visit(node.get_index(), out);
   }
 
+  void visit(const FieldExpression &node, OutputIterator &out) override {
+    std::size_t id = get_next_id();
+    write_node(out, id, "FieldExpression");
+    write_edge_labeled(out, id, node_id, "base");
+    visit(node.get_base(), out);
+    write_edge_labeled(out, id, node_id, "field");
+    visit(node.get_field(), out);
+  }
+
   void visit(const FunctionCall &node, OutputIterator &out) override {
     std::size_t id = get_next_id();
     write_node(out, id, "FunctionCall");
@@ -282,6 +303,10 @@ public:
     write_node(out, get_next_id(), "Number\\n{}", node.get_value());
   }
 
+  void visit(const BigNumber &node, OutputIterator &out) override {
+    write_node(out, get_next_id(), "BigNumber\\n{}", node.get_value());
+  }
+
   void visit(const Float &node, OutputIterator &out) override {
     write_node(out, get_next_id(), "Float\\n{}", node.get_value());
   }
@@ -359,6 +384,15 @@ public:
     visit(node.get_expression(), out);
   }
 
+  void visit(const RecordDeclaration &node, OutputIterator &out) override {
+    std::size_t id = get_next_id();
+    write_node(out, id, "RecordDeclaration");
+    write_edge_labeled(out, id, node_id, "name");
+    visit(node.get_name(), out);
+    write_edge_labeled(out, id, node_id, "fields");
+    visit(node.get_fields(), out);
+  }
+
   void visit(const OperatorAssignment &node, OutputIterator &out) override {
     std::size_t id = get_next_id();
     write_node(out, id, "OperatorAssignment\\n{}", node.get_operator());
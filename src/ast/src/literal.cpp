@@ -21,6 +21,9 @@ Boolean::Boolean(bool value, location::Location location)
 Number::Number(std::int64_t value, location::Location location)
     : value(value), location_(location) {}
 
+BigNumber::BigNumber(std::string digits, location::Location location)
+    : value(std::move(digits)), location_(location) {}
+
 Float::Float(std::int64_t integral, location::Location location)
     : value(static_cast<double>(integral)), location_(location) {}
 Float::Float(
@@ -62,9 +65,11 @@ Literal::Literal() = default;
 Literal::Literal(Nil nil) : inner(nil) {}
 Literal::Literal(Boolean boolean) : inner(boolean) {}
 Literal::Literal(Number num) : inner(num) {}
+Literal::Literal(BigNumber &&num) : inner(std::move(num)) {}
 Literal::Literal(Float num) : inner(num) {}
 Literal::Literal(String &&string) : inner(std::move(string)) {}
 Literal::Literal(Array &&array) : inner(std::move(array)) {}
+Literal::Literal(Dict &&dict) : inner(std::move(dict)) {}
 
 const location::Location &Literal::get_location() const {
   return std::visit(
@@ -7,6 +7,7 @@ import utils;
 import l3.location;
 
 export import :array;
+export import :dict;
 
 export namespace l3::ast {
 
@@ -38,6 +39,18 @@ public:
   DEFINE_ACCESSOR_X(value);
 };
 
+// Integer literal beyond the int range, kept as its decimal digits
+class BigNumber {
+  std::string value;
+
+  DEFINE_LOCATION_FIELD()
+
+public:
+  BigNumber(std::string digits, location::Location location = {});
+
+  DEFINE_ACCESSOR_X(value);
+};
+
 class Float {
   double value;
 
@@ -72,16 +85,19 @@ char decode_escape(char c);
 export namespace l3::ast {
 
 class Literal {
-  std::variant<Nil, Boolean, Number, Float, String, Array> inner;
+  std::variant<Nil, Boolean, Number, BigNumber, Float, String, Array, Dict>
+      inner;
 
 public:
   Literal();
   Literal(Nil nil);
   Literal(Boolean boolean);
   Literal(Number num);
+  Literal(BigNumber &&num);
   Literal(Float num);
   Literal(String &&string);
   Literal(Array &&array);
+  Literal(Dict &&dict);
 
   VISIT(inner)
 
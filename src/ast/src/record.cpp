@@ -0,0 +1,12 @@
+module l3.ast;
+
+namespace l3::ast {
+
+RecordDeclaration::RecordDeclaration(location::Location location)
+    : location_(location) {}
+RecordDeclaration::RecordDeclaration(
+    Identifier &&name, NameList &&fields, location::Location location
+)
+    : name(std::move(name)), fields(std::move(fields)), location_(location) {}
+
+} // namespace l3::ast
@@ -0,0 +1,29 @@
+export module l3.ast:record;
+
+import std;
+
+import l3.location;
+
+import :identifier;
+import :name_list;
+
+export namespace l3::ast {
+
+// `record Name(field, ...)`, declares a record type with fixed fields
+class RecordDeclaration {
+  Identifier name;
+  NameList fields;
+
+  DEFINE_LOCATION_FIELD()
+
+public:
+  RecordDeclaration(location::Location location = {});
+  RecordDeclaration(
+      Identifier &&name, NameList &&fields, location::Location location = {}
+  );
+
+  DEFINE_ACCESSOR_X(name);
+  DEFINE_ACCESSOR_X(fields);
+};
+
+} // namespace l3::ast
@@ -25,6 +25,8 @@ Statement::Statement(NamedFunction &&function) : inner(std::move(function)) {}
 Statement::Statement(OperatorAssignment &&assignment)
     : inner(std::move(assignment)) {}
 Statement::Statement(RangeForLoop &&loop) : inner(std::move(loop)) {}
+Statement::Statement(RecordDeclaration &&record)
+    : inner(std::move(record)) {}
 Statement::Statement(While &&loop) : inner(std::move(loop)) {}
 
 const location::Location &Statement::get_location() const {
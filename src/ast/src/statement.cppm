@@ -13,6 +13,7 @@ import :function;
 import :function_call;
 import :if_else;
 import :range_for_loop;
+import :record;
 import :while_loop;
 
 export namespace l3::ast {
@@ -27,6 +28,7 @@ class Statement {
       NamedFunction,
       OperatorAssignment,
       RangeForLoop,
+      RecordDeclaration,
       While>
       inner;
 
@@ -47,6 +49,7 @@ public:
   Statement(NamedFunction &&function);
   Statement(OperatorAssignment &&assignment);
   Statement(RangeForLoop &&loop);
+  Statement(RecordDeclaration &&record);
   Statement(While &&loop);
 
   VISIT(inner)
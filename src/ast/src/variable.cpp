@@ -16,9 +16,23 @@ IndexExpression &
 IndexExpression::operator=(IndexExpression &&) noexcept = default;
 IndexExpression::~IndexExpression() = default;
 
+FieldExpression::FieldExpression(location::Location location)
+    : location_(location) {}
+FieldExpression::FieldExpression(
+    Variable &&base, Identifier &&field, location::Location location
+)
+    : base(std::make_unique<Variable>(std::move(base))),
+      field(std::move(field)), location_(location) {};
+
+FieldExpression::FieldExpression(FieldExpression &&) noexcept = default;
+FieldExpression &
+FieldExpression::operator=(FieldExpression &&) noexcept = default;
+FieldExpression::~FieldExpression() = default;
+
 Variable::Variable() = default;
 Variable::Variable(Identifier &&id) : inner(std::move(id)) {}
 Variable::Variable(IndexExpression &&ie) : inner(std::move(ie)) {}
+Variable::Variable(FieldExpression &&fe) : inner(std::move(fe)) {}
 
 const location::Location &Variable::get_location() const {
   return std::visit(
@@ -33,13 +33,37 @@ public:
   DEFINE_PTR_ACCESSOR_X(index)
 };
 
+// `base.field`, a field of a record
+class FieldExpression {
+  std::unique_ptr<Variable> base;
+  Identifier field;
+
+  DEFINE_LOCATION_FIELD()
+
+public:
+  FieldExpression(location::Location location = {});
+  FieldExpression(
+      Variable &&base, Identifier &&field, location::Location location = {}
+  );
+
+  FieldExpression(const FieldExpression &) = delete;
+  FieldExpression(FieldExpression &&) noexcept;
+  FieldExpression &operator=(const FieldExpression &) = delete;
+  FieldExpression &operator=(FieldExpression &&) noexcept;
+  ~FieldExpression();
+
+  DEFINE_PTR_ACCESSOR_X(base)
+  DEFINE_ACCESSOR_X(field)
+};
+
 class Variable {
-  std::variant<Identifier, IndexExpression> inner;
+  std::variant<Identifier, IndexExpression, FieldExpression> inner;
 
 public:
   Variable();
   Variable(Identifier &&id);
   Variable(IndexExpression &&ie);
+  Variable(FieldExpression &&fe);
 
   VISIT(inner);
 
@@ -5,12 +5,14 @@ import std;
 export namespace l3::ast {
 
 class Array;
+class Dict;
 class NameList;
 class UnaryExpression;
 class BinaryExpression;
 class LogicalExpression;
 class Comparison;
 class IndexExpression;
+class FieldExpression;
 class FunctionCall;
 class FunctionBody;
 class IfBase;
@@ -28,6 +30,7 @@ class Identifier;
 class Nil;
 class Boolean;
 class Number;
+class BigNumber;
 class Float;
 class String;
 class Literal;
@@ -40,6 +43,7 @@ class AnonymousFunction;
 class Declaration;
 class NameAssignment;
 class OperatorAssignment;
+class RecordDeclaration;
 
 template <
     typename T = char,
@@ -47,12 +51,14 @@ template <
 class AstVisitor {
 public:
   virtual void visit(const Array &node, OutputIterator &out) = 0;
+  virtual void visit(const Dict &node, OutputIterator &out) = 0;
   virtual void visit(const NameList &node, OutputIterator &out) = 0;
   virtual void visit(const UnaryExpression &node, OutputIterator &out) = 0;
   virtual void visit(const BinaryExpression &node, OutputIterator &out) = 0;
   virtual void visit(const LogicalExpression &node, OutputIterator &out) = 0;
   virtual void visit(const Comparison &node, OutputIterator &out) = 0;
   virtual void visit(const IndexExpression &node, OutputIterator &out) = 0;
+  virtual void visit(const FieldExpression &node, OutputIterator &out) = 0;
   virtual void visit(const FunctionCall &node, OutputIterator &out) = 0;
   virtual void visit(const FunctionBody &node, OutputIterator &out) = 0;
   virtual void visit(const IfBase &node, OutputIterator &out) = 0;
@@ -70,6 +76,7 @@ public:
   virtual void visit(const Nil &node, OutputIterator &out) = 0;
   virtual void visit(const Boolean &node, OutputIterator &out) = 0;
   virtual void visit(const Number &node, OutputIterator &out) = 0;
+  virtual void visit(const BigNumber &node, OutputIterator &out) = 0;
   virtual void visit(const Float &node, OutputIterator &out) = 0;
   virtual void visit(const String &node, OutputIterator &out) = 0;
   virtual void visit(const Literal &node, OutputIterator &out) = 0;
@@ -82,6 +89,7 @@ public:
   virtual void visit(const Declaration &node, OutputIterator &out) = 0;
   virtual void visit(const NameAssignment &node, OutputIterator &out) = 0;
   virtual void visit(const OperatorAssignment &node, OutputIterator &out) = 0;
+  virtual void visit(const RecordDeclaration &node, OutputIterator &out) = 0;
 };
 
 } // namespace l3::ast
@@ -14,6 +14,25 @@ void Chunk::write(Instruction instruction, location::Location location) {
   locations.push_back(std::move(location));
 }
 
+void ProgramBytecode::freeze_constants() {
+  constant_values.clear();
+  constant_values.reserve(constants.size());
+  for (auto &constant : constants) {
+    constant.make_immortal();
+    if (constant.get_value().is_string()) {
+      // Folded concatenations may have built the constant into a shared
+      // buffer, which concatenations at runtime would otherwise grow
+      std::get<runtime::String>(constant.get_value().get_inner()).unshare();
+      runtime::StringTable::flag_interned(constant);
+    }
+    constant.get_value().visit(
+        [&](runtime::Nil) { constant_values.emplace_back(); },
+        [&](runtime::Primitive p) { constant_values.emplace_back(p); },
+        [&](const auto &) { constant_values.emplace_back(&constant); }
+    );
+  }
+}
+
 std::string format_instruction(
     const Instruction &inst, const ProgramBytecode &program, std::size_t offset
 ) {
@@ -110,6 +129,11 @@ std::string format_instruction(
       [&](const OpSetLocal &op) {
         return std::format("{}{:<10} {:4d}\n", header(), "SET_LOCAL", op.index);
       },
+      [&](const OpAddAssign &op) {
+        return std::format(
+            "{}{:<10} {:4d}\n", header(), "ADD_ASSIGN", op.index
+        );
+      },
       [&](const OpForLoop &op) {
         auto step = op.step_index ? std::format("step={:4d}", *op.step_index)
                                   : "step=const1";
@@ -157,12 +181,49 @@ std::string format_instruction(
             "{}{:<10} {:4d}\n", header(), "MAKE_ARRAY", op.count
         );
       },
+      [&](const OpMakeDict &op) {
+        return std::format("{}{:<10} {:4d}\n", header(), "MAKE_DICT", op.count);
+      },
       [&](const OpGetIndex &) {
         return std::format("{}GET_INDEX\n", header());
       },
       [&](const OpSetIndex &) {
         return std::format("{}SET_INDEX\n", header());
       },
+      [&](const OpGetElement &) {
+        return std::format("{}GET_ELEMENT\n", header());
+      },
+      [&](const OpMakeRecord &op) {
+        return std::format(
+            "{}{:<10} {:4d} '{}'\n",
+            header(),
+            "MAKE_RECORD",
+            op.record,
+            program.records[op.record]->name
+        );
+      },
+      [&](const OpGetField &op) {
+        const auto &shape = *program.records[op.record];
+        return std::format(
+            "{}{:<10} {:4d} '{}.{}'\n",
+            header(),
+            "GET_FIELD",
+            op.record,
+            shape.name,
+            shape.fields[op.slot]
+        );
+      },
+      [&](const OpSetField &op) {
+        const auto &shape = *program.records[op.record];
+        return std::format(
+            "{}{:<10} {:4d} '{}.{}'\n",
+            header(),
+            "SET_FIELD",
+            op.record,
+            shape.name,
+            shape.fields[op.slot]
+        );
+      },
       [&](const OpClosure &op) {
         auto result = std::format(
             "{}{:<10} {:4d} '{}'\n",
@@ -64,6 +64,10 @@ struct OpGetLocal {
 struct OpSetLocal {
   std::size_t index = -1UZ;
 };
+// `local += value`, appends in place when the local's cell is exclusive
+struct OpAddAssign {
+  std::size_t index = -1UZ;
+};
 
 struct OpForLoop {
   std::size_t control_index = -1UZ;
@@ -104,8 +108,28 @@ struct OpCall {
 struct OpMakeArray {
   std::size_t count = -1UZ;
 };
+// Pops `count` key and value pairs
+struct OpMakeDict {
+  std::size_t count = -1UZ;
+};
 struct OpGetIndex {};
 struct OpSetIndex {};
+// Element of a collection by position in iteration order, read by `for` loops
+struct OpGetElement {};
+// Pops the fields of `program.records[record]` and pushes a new instance
+struct OpMakeRecord {
+  std::size_t record = -1UZ;
+};
+// Field access resolved by the compiler to `slot` of `program.records[record]`.
+// Instances of other records fall back to a lookup of the field by name.
+struct OpGetField {
+  std::size_t record = -1UZ;
+  std::size_t slot = -1UZ;
+};
+struct OpSetField {
+  std::size_t record = -1UZ;
+  std::size_t slot = -1UZ;
+};
 
 // ----------------------------------------------------------------------------
 // Instruction
@@ -133,13 +157,19 @@ using Instruction = std::variant<
     OpSetGlobal,
     OpGetLocal,
     OpSetLocal,
+    OpAddAssign,
     OpForLoop,
     OpJump,
     OpJumpIf,
     OpCall,
     OpMakeArray,
+    OpMakeDict,
     OpGetIndex,
     OpSetIndex,
+    OpGetElement,
+    OpMakeRecord,
+    OpGetField,
+    OpSetField,
     OpClosure,
     OpGetUpvalue,
     OpSetUpvalue>;
@@ -158,7 +188,24 @@ public:
 struct ProgramBytecode {
   std::vector<Chunk> chunks;
   std::vector<runtime::HeapCell> constants;
-};
+  // Values pushed by OpConstant, precomputed by freeze_constants(). Heap
+  // constants point into `constants`, which must not be resized afterwards.
+  std::vector<runtime::StackValue> constant_values;
+  // Shapes of the declared records, indexed by OpMakeRecord and OpGetField
+  std::vector<std::shared_ptr<const runtime::RecordShape>> records;
+  // Names and arities of the compiled functions, closures point into these
+  std::vector<std::shared_ptr<const runtime::FunctionPrototype>> prototypes;
+
+  // Marks all constants immortal, caches the hashes of string constants and
+  // precomputes their stack values. Called once the constant pool is final,
+  // VMs running the program never write to it afterwards.
+  void freeze_constants();
+};
+
+// A compiled program ready to run. It is never modified once compiled, so any
+// number of VMs on any threads can execute one SharedProgram at the same time.
+// Everything a run changes lives in the VM.
+using SharedProgram = std::shared_ptr<const ProgramBytecode>;
 
 [[nodiscard]] std::string format_instruction(
     const Instruction &inst, const ProgramBytecode &program, std::size_t offset
@@ -48,6 +48,7 @@ void Compiler::compile(const ast::Program &ast_program) {
   emit(OpReturn{});
   optimize(program);
   deduplicate_constants();
+  program.freeze_constants();
 }
 
 Chunk &Compiler::current_chunk() {
@@ -96,14 +97,19 @@ void Compiler::end_scope(bool emit_pop) {
     count++;
     locals().pop_back();
   }
+  auto &records = contexts.back().records;
+  while (!records.empty() && records.back().depth > scope_depth()) {
+    records.pop_back();
+  }
   if (emit_pop) {
     emit(OpPop{.count = count});
   }
 }
 
-std::size_t Compiler::add_local(const ast::Identifier &name) {
+std::size_t
+Compiler::add_local(const ast::Identifier &name, bool is_mutable) {
   auto index = locals().size();
-  locals().emplace_back(name, scope_depth());
+  locals().emplace_back(name, scope_depth(), is_mutable);
   return index;
 }
 
@@ -161,6 +167,12 @@ Compiler::resolve_upvalue(const ast::Identifier &name) {
       result = add_upvalue_to_context(false, result, contexts[j]);
     }
 
+    if (ctx.locals[*index].is_mutable) {
+      for (std::size_t j = i + 1; j < contexts.size(); ++j) {
+        contexts[j].captures_mutable = true;
+      }
+    }
+
     return result;
   }
   return std::nullopt;
@@ -225,14 +237,48 @@ std::size_t Compiler::make_constant(runtime::HeapData &&value) {
   return index;
 }
 
+std::size_t Compiler::make_function(
+    std::size_t chunk_id,
+    std::string name,
+    std::size_t arity,
+    bool captures_mutable
+) {
+  const auto &prototype = *program.prototypes.emplace_back(
+      std::make_shared<const runtime::FunctionPrototype>(
+          runtime::FunctionPrototype{
+              .id = chunk_id,
+              .name = std::move(name),
+              .arity = arity,
+              .captures_mutable = captures_mutable
+          }
+      )
+  );
+  runtime::BytecodeFunction function{prototype};
+  return make_constant(runtime::Function{std::move(function)});
+}
+
 void Compiler::deduplicate_constants() {
   std::vector<std::size_t> index_map(program.constants.size(), 0UZ);
   std::vector<runtime::HeapCell> deduped_constants;
+  // Strings (including all identifiers) are looked up by hash instead of
+  // being compared against every previous constant
+  std::unordered_map<std::string, std::size_t> string_indices;
 
   for (const auto &[old_index, constant] :
        utils::ranges::enumerate(program.constants)) {
     const auto &value = constant.get_value();
 
+    if (const auto string = value.as_string()) {
+      const auto [it, inserted] = string_indices.try_emplace(
+          std::string{*string}, deduped_constants.size()
+      );
+      index_map[old_index] = it->second;
+      if (inserted) {
+        deduped_constants.emplace_back(std::move(constant));
+      }
+      continue;
+    }
+
     auto it =
         std::ranges::find_if(deduped_constants, [&value](const auto &other) {
           return value.compare(other.get_value()) ==
@@ -302,6 +348,7 @@ void Compiler::compile_statements(std::ranges::input_range auto &statements) {
           emit_nil();
           add_local(func.get_name());
         },
+        [this](const ast::RecordDeclaration &decl) { declare_record(decl); },
         [](const auto &) {}
     );
   }
@@ -479,16 +526,11 @@ void Compiler::compile_comparison(const ast::Comparison &comparison) {
 }
 
 void Compiler::compile_anonymous_function(const ast::AnonymousFunction &func) {
-  auto [used_upvalues, new_chunk_id] = compile_function_body(func.get_body());
-
-  std::size_t id = make_constant(
-      runtime::Function{runtime::BytecodeFunction{
-          .id = new_chunk_id,
-          .name = "<anonymous>",
-          .arity = func.get_arity(),
-          .curried_args = {},
-          .captured_upvalue_refs = {}
-      }}
+  auto [used_upvalues, new_chunk_id, captures_mutable] =
+      compile_function_body(func.get_body());
+
+  std::size_t id = make_function(
+      new_chunk_id, "<anonymous>", func.get_arity(), captures_mutable
   );
 
   if (used_upvalues.empty()) {
@@ -498,7 +540,125 @@ void Compiler::compile_anonymous_function(const ast::AnonymousFunction &func) {
   }
 }
 
+void Compiler::declare_record(const ast::RecordDeclaration &decl) {
+  const auto &name = decl.get_name().get_name();
+  auto &records = contexts.back().records;
+  if (std::ranges::any_of(records, [&](const ScopedRecord &record) {
+        return record.depth == scope_depth() && record.name == name;
+      })) {
+    throw CompileError(std::format("Record {} is already defined", name));
+  }
+
+  runtime::RecordShape shape{.name = name, .fields = {}};
+  for (const auto &field : decl.get_fields()) {
+    if (shape.slot(field.get_name())) {
+      throw CompileError(
+          std::format(
+              "Record {} has a duplicate field {}", name, field.get_name()
+          )
+      );
+    }
+    shape.fields.push_back(field.get_name());
+  }
+
+  records.push_back(
+      {.name = name, .depth = scope_depth(), .index = program.records.size()}
+  );
+  program.records.push_back(
+      std::make_shared<const runtime::RecordShape>(std::move(shape))
+  );
+}
+
+// Contexts are searched from the innermost, the first one declaring a record
+// or a variable named `name` decides. Within a context the innermost of the
+// two wins, a variable declared in the scope of the record hides it since
+// records are hoisted.
+std::optional<std::size_t>
+Compiler::resolve_record(const ast::Identifier &name) const {
+  for (const auto &context : std::views::reverse(contexts)) {
+    const auto local = resolve_in_context(name, context);
+    const auto records = std::views::reverse(context.records);
+    const auto record =
+        std::ranges::find(records, name.get_name(), &ScopedRecord::name);
+    if (record != records.end()) {
+      if (local && context.locals[*local].depth >= record->depth) {
+        return std::nullopt;
+      }
+      return record->index;
+    }
+    if (local) {
+      return std::nullopt;
+    }
+  }
+  return std::nullopt;
+}
+
+std::size_t Compiler::record_constructor(std::size_t record) {
+  if (const auto it = record_constructors.find(record);
+      it != record_constructors.end()) {
+    return it->second;
+  }
+  const auto &shape = *program.records[record];
+  const auto chunk_id = push_context();
+  // The arguments are the only values on the stack of the call, they become
+  // the fields
+  emit(OpMakeRecord{record});
+  emit(OpReturn{});
+  pop_context();
+
+  const auto constant =
+      make_function(chunk_id, shape.name, shape.fields.size(), false);
+  record_constructors.emplace(record, constant);
+  return constant;
+}
+
+// Slots are resolved against the first record declaring the field, the VM
+// looks the field up by name for instances of other records
+Compiler::ResolvedField
+Compiler::resolve_field(const ast::Identifier &field) const {
+  for (const auto &[index, shape] : utils::ranges::enumerate(program.records)) {
+    if (const auto slot = shape->slot(field.get_name())) {
+      return {.record = index, .slot = *slot};
+    }
+  }
+  throw CompileError(
+      std::format("No record has a field named {}", field.get_name())
+  );
+}
+
+bool Compiler::compile_record_construction(const ast::FunctionCall &call) {
+  const auto record = resolve_record(call.get_name());
+  if (!record) {
+    return false;
+  }
+
+  const auto &shape = *program.records[*record];
+  const auto &args = call.get_arguments();
+  if (args.size() > shape.fields.size()) {
+    throw CompileError(
+        std::format(
+            "Record {} expects {} fields, got {}",
+            shape.name,
+            shape.fields.size(),
+            args.size()
+        )
+    );
+  }
+  // Partial applications call the constructor function instead
+  if (args.size() < shape.fields.size()) {
+    return false;
+  }
+  for (const auto &arg : args) {
+    compile_expression(arg);
+  }
+  emit(OpMakeRecord{*record});
+  return true;
+}
+
 void Compiler::compile_function_call(const ast::FunctionCall &call) {
+  if (compile_record_construction(call)) {
+    return;
+  }
   compile_variable(ast::Variable{ast::Identifier{call.get_name()}});
   const auto &args = call.get_arguments();
   for (const auto &arg : args) {
@@ -539,12 +699,21 @@ void Compiler::compile_if_expression(const ast::IfExpression &if_expr) {
 void Compiler::compile_variable(const ast::Variable &variable) {
   variable.visit(
       [this](const ast::Identifier &identifier) {
+        if (const auto record = resolve_record(identifier)) {
+          emit(OpConstant{record_constructor(*record)});
+          return;
+        }
         emit(emit_get_variable(identifier));
       },
       [this](const ast::IndexExpression &index) {
         compile_variable(index.get_base());
         compile_expression(index.get_index());
         emit(OpGetIndex{});
+      },
+      [this](const ast::FieldExpression &field) {
+        compile_variable(field.get_base());
+        const auto [record, slot] = resolve_field(field.get_field());
+        emit(OpGetField{.record = record, .slot = slot});
       }
   );
 }
@@ -559,6 +728,14 @@ void Compiler::compile_literal(const ast::Literal &literal) {
         }
         emit(OpMakeArray{elements.size()});
       },
+      [this](const ast::Dict &dict) {
+        for (const auto &[key, value] :
+             std::views::zip(dict.get_keys(), dict.get_values())) {
+          compile_expression(key);
+          compile_expression(value);
+        }
+        emit(OpMakeDict{dict.get_keys().size()});
+      },
       [this](const ast::String &string) {
         emit(
             OpConstant{make_constant(
@@ -566,6 +743,11 @@ void Compiler::compile_literal(const ast::Literal &literal) {
             )}
         );
       },
+      [this](const ast::BigNumber &number) {
+        emit(OpConstant{make_constant(
+            runtime::HeapData{runtime::BigInt::from_digits(number.get_value())}
+        )});
+      },
       [this](const auto &literal_value) {
         emit(
             OpConstant{make_constant(
@@ -595,6 +777,8 @@ void Compiler::compile_statement(const ast::Statement &stmt) {
         compile_operator_assignment(assign);
       },
       [this](const ast::RangeForLoop &loop) { compile_range_for_loop(loop); },
+      // Declared when hoisted by compile_statements
+      [](const ast::RecordDeclaration &) {},
       [this](const ast::While &loop) { compile_while_loop(loop); }
   );
 }
@@ -608,13 +792,13 @@ void Compiler::compile_declaration(const ast::Declaration &decl) {
       emit_nil();
     }
 
-    add_local(names.front());
+    add_local(names.front(), decl.is_mutable());
     return;
   }
   if (!decl.get_expression()) {
     for (const auto &ident : names) {
       emit_nil();
-      add_local(ident);
+      add_local(ident, decl.is_mutable());
     }
     return;
   }
@@ -636,7 +820,7 @@ void Compiler::compile_declaration(const ast::Declaration &decl) {
     emit(OpGetIndex{});
 
     const auto &name = names[i];
-    add_local(name);
+    add_local(name, decl.is_mutable());
   }
 }
 
@@ -677,8 +861,8 @@ void Compiler::compile_for_loop(const ast::ForLoop &loop) {
   const auto preamble = begin_loop();
   emit(OpGetLocal{coll_idx});
   emit(OpGetLocal{index_idx});
-  emit(OpGetIndex{});
-  add_local(loop.get_variable());
+  emit(OpGetElement{});
+  add_local(loop.get_variable(), loop.is_mutable());
 
   compile_block(loop.get_body());
 
@@ -700,6 +884,11 @@ void Compiler::compile_for_loop(const ast::ForLoop &loop) {
 }
 
 void Compiler::compile_function_call_statement(const ast::FunctionCall &call) {
+  if (compile_record_construction(call)) {
+    emit(OpPop{});
+    return;
+  }
+
   compile_variable(ast::Variable{ast::Identifier{call.get_name().get_name()}});
 
   for (const auto &arg : call.get_arguments()) {
@@ -779,8 +968,13 @@ Compiler::compile_function_body(const ast::FunctionBody &body) {
   }
 
   auto used_upvalues = std::move(upvalues());
+  const auto captures_mutable = contexts.back().captures_mutable;
   pop_context();
-  return {.upvalues = std::move(used_upvalues), .chunk_id = chunk_id};
+  return {
+      .upvalues = std::move(used_upvalues),
+      .chunk_id = chunk_id,
+      .captures_mutable = captures_mutable
+  };
 }
 
 void Compiler::compile_named_function(const ast::NamedFunction &func) {
@@ -795,16 +989,11 @@ void Compiler::compile_named_function(const ast::NamedFunction &func) {
     );
   }
 
-  auto [used_upvalues, chunk_id] = compile_function_body(func.get_body());
+  auto [used_upvalues, chunk_id, captures_mutable] =
+      compile_function_body(func.get_body());
 
-  const auto constant = make_constant(
-      runtime::Function{runtime::BytecodeFunction{
-          .id = chunk_id,
-          .name = name.get_name(),
-          .arity = func.get_arity(),
-          .curried_args = {},
-          .captured_upvalue_refs = {}
-      }}
+  const auto constant = make_function(
+      chunk_id, name.get_name(), func.get_arity(), captures_mutable
   );
 
   if (used_upvalues.empty()) {
@@ -825,6 +1014,15 @@ void Compiler::compile_operator_assignment(
 ) {
   assign.get_variable().visit(
       [&](const ast::Identifier &id) {
+        if (assign.get_operator() == ast::AssignmentOperator::Plus) {
+          if (const auto resolved = resolve_variable(id);
+              resolved.type == VariableType::Local) {
+            compile_expression(assign.get_expression());
+            emit(OpAddAssign{resolved.index});
+            return;
+          }
+        }
+
         if (assign.get_operator() != ast::AssignmentOperator::Assign) {
           emit(emit_get_variable(id));
         }
@@ -850,7 +1048,8 @@ void Compiler::compile_operator_assignment(
           emit(OpModulo{});
           break;
         case ast::AssignmentOperator::Power:
-          break; // TODO
+          emit(OpPower{});
+          break;
         }
 
         emit(emit_set_variable(id));
@@ -882,6 +1081,7 @@ void Compiler::compile_operator_assignment(
             emit(OpModulo{});
             break;
           case ast::AssignmentOperator::Power:
+            emit(OpPower{});
             break;
           default:
             std::unreachable();
@@ -894,6 +1094,41 @@ void Compiler::compile_operator_assignment(
           compile_expression(assign.get_expression());
           emit(OpSetIndex{});
         }
+      },
+      [&](const ast::FieldExpression &field) {
+        const auto [record, slot] = resolve_field(field.get_field());
+        compile_variable(field.get_base());
+        if (assign.get_operator() != ast::AssignmentOperator::Assign) {
+          emit(OpDuplicate{0});
+          emit(OpGetField{.record = record, .slot = slot});
+        }
+
+        compile_expression(assign.get_expression());
+
+        switch (assign.get_operator()) {
+        case ast::AssignmentOperator::Assign:
+          break;
+        case ast::AssignmentOperator::Plus:
+          emit(OpAdd{});
+          break;
+        case ast::AssignmentOperator::Minus:
+          emit(OpSubtract{});
+          break;
+        case ast::AssignmentOperator::Multiply:
+          emit(OpMultiply{});
+          break;
+        case ast::AssignmentOperator::Divide:
+          emit(OpDivide{});
+          break;
+        case ast::AssignmentOperator::Modulo:
+          emit(OpModulo{});
+          break;
+        case ast::AssignmentOperator::Power:
+          emit(OpPower{});
+          break;
+        }
+
+        emit(OpSetField{.record = record, .slot = slot});
       }
   );
 }
@@ -921,7 +1156,7 @@ void Compiler::compile_range_for_loop(const ast::RangeForLoop &loop) {
 
   const auto preamble = begin_loop();
   emit(OpGetLocal{current_idx});
-  add_local(loop.get_variable());
+  add_local(loop.get_variable(), loop.is_mutable());
 
   compile_block(loop.get_body());
 
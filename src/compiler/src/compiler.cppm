@@ -18,6 +18,15 @@ export class CompileError : public std::runtime_error {
 struct Local {
   ast::Identifier name;
   int depth = -1;
+  bool is_mutable = false;
+};
+
+// Record declared in a scope, hoisted to the start of its block
+struct ScopedRecord {
+  std::string name;
+  int depth = -1;
+  // Index of the shape in `program.records`
+  std::size_t index;
 };
 
 struct Context {
@@ -26,6 +35,10 @@ struct Context {
   std::size_t chunk_id;
   int scope_depth = 0;
   bool is_in_expression = false;
+  // Whether one of the upvalues, directly or through an enclosing function,
+  // is a `mut` variable
+  bool captures_mutable = false;
+  std::vector<ScopedRecord> records;
 };
 
 export class Compiler {
@@ -47,6 +60,7 @@ private:
   struct CompiledFunctionBody {
     std::vector<Upvalue> upvalues;
     std::size_t chunk_id;
+    bool captures_mutable;
   };
 
   enum class VariableType : std::uint8_t { Local, Upvalue, Global };
@@ -63,7 +77,25 @@ private:
   Instruction emit_get_variable(const ast::Identifier &name);
   Instruction emit_set_variable(const ast::Identifier &name);
 
-  std::size_t add_local(const ast::Identifier &name);
+  // Records are scoped like locals, and shadowed by variables of the same
+  // name declared in inner scopes or later in the same scope. Their shapes
+  // are program-wide, so that fields resolve on any record.
+  struct ResolvedField {
+    std::size_t record;
+    std::size_t slot;
+  };
+  // Constants holding the constructor function of a record, by record index.
+  // Made when the record is first used as a value.
+  std::unordered_map<std::size_t, std::size_t> record_constructors;
+
+  void declare_record(const ast::RecordDeclaration &decl);
+  [[nodiscard]] std::optional<std::size_t>
+  resolve_record(const ast::Identifier &name) const;
+  std::size_t record_constructor(std::size_t record);
+  [[nodiscard]] ResolvedField resolve_field(const ast::Identifier &field) const;
+  bool compile_record_construction(const ast::FunctionCall &call);
+
+  std::size_t add_local(const ast::Identifier &name, bool is_mutable = false);
   ast::Identifier make_synthetic_name(std::string_view prefix);
 
   struct LoopContext {
@@ -87,6 +119,14 @@ private:
   void emit(Instruction instruction);
   void emit(Instruction instruction, const location::Location &location);
   std::size_t make_constant(runtime::HeapData &&value = {});
+  // Registers the prototype of a compiled function and a constant holding a
+  // closure over it without upvalues
+  std::size_t make_function(
+      std::size_t chunk_id,
+      std::string name,
+      std::size_t arity,
+      bool captures_mutable
+  );
   void emit_nil();
   void deduplicate_constants();
   void emit_loop(std::size_t loop_start);
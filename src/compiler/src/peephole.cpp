@@ -46,7 +46,8 @@ fold_binary(const Instruction &op, const HeapData &lhs, const HeapData &rhs) {
   const auto safe = [&](auto &&fn) -> std::optional<HeapData> {
     try {
       return fn();
-    } catch (const UnsupportedOperation &) {
+    } catch (const RuntimeError &) {
+      // Raised when the program runs instead
       return std::nullopt;
     }
   };
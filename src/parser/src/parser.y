@@ -56,11 +56,12 @@
 
 %token _if _else _while _break _continue _return _for in _do _true _false then
        end nil function let equal _not lparen rparen lbrace rbrace lbracket
-       rbracket comma semi plus_equal minus_equal mul_equal div_equal mod_equal
-       pow_equal elif mut step dot dot_dot dot_dot_equal
+       rbracket comma colon semi plus_equal minus_equal mul_equal div_equal mod_equal
+       pow_equal elif mut step dot dot_dot dot_dot_equal record
        <std::string> id
        <std::string> string
        <std::int64_t> number
+       <std::string> big_number
 
 %type
       <AnonymousFunction> ANONYMOUS_FUNCTION
@@ -72,6 +73,8 @@
       <Comparison> COMPARISON
       <ComparisonOperator> COMPARISON_OP
       <Declaration> DECLARATION
+      <Dict> DICT
+      <Dict> DICT_ENTRIES
       <ElseIfList> IF_ELSE
       <Expression> ATOMIC_EXPRESSION
       <Expression> EXPRESSION
@@ -99,6 +102,7 @@
       <NameList> MULTIPLE_NAME_LIST
       <NameList> NAME_LIST
       <NameList> PARAMETERS
+      <RecordDeclaration> RECORD_DEFINITION
       <ReturnStatement> RETURN
       <Statement> SEMI_STATEMENT
       <Statement> STATEMENT
@@ -115,13 +119,25 @@ LITERAL: nil               { $$ = { Nil { @$ } }; }
        | _true             { $$ = { Boolean { true, @$ } }; }
        | _false            { $$ = { Boolean { false, @$ } }; }
        | number            { $$ = { Number { $1, @$ } }; }
+       | big_number        { $$ = { BigNumber { std::move($1), @$ } }; }
        | number dot        { $$ = { Float { $1, @$ } }; }
        | number dot number { $$ = { Float { $1, $3, @$ } }; }
        | string            { $$ = { String { $1, @$ } }; }
        | ARRAY             { $$ = { std::move($1) }; }
+       | DICT              { $$ = { std::move($1) }; }
 
 ARRAY: lbracket EXPRESSION_LIST rbracket { $$ = { std::move($2), @$ }; }
 
+DICT: lbrace DICT_ENTRIES rbrace
+      { $$ = { std::move($2.get_keys()), std::move($2.get_values()), @$ }; }
+
+DICT_ENTRIES: PRIMARY_EXPRESSION colon PRIMARY_EXPRESSION comma DICT_ENTRIES
+              { $$ = std::move($5.with_entry(std::move($1), std::move($3))); }
+            | PRIMARY_EXPRESSION colon PRIMARY_EXPRESSION
+              { $$ = std::move(Dict{}.with_entry(std::move($1), std::move($3))); }
+            | %empty
+              { $$ = {}; }
+
 // Identifiers and Variables
 IDENTIFIER: id { $$ = { std::move($1), @$ }; }
 
@@ -129,6 +145,8 @@ INDEX: lbracket PRIMARY_EXPRESSION rbracket { $$ = { std::move($2) }; }
 
 VAR: IDENTIFIER { $$ = { std::move($1) }; }
    | VAR INDEX  { $$ = { IndexExpression { std::move($1), std::move($2), @$ } }; }
+   | VAR dot IDENTIFIER
+     { $$ = { FieldExpression { std::move($1), std::move($3), @$ } }; }
 
 NAME_LIST: NAME_LIST comma IDENTIFIER
            { $$ = std::move($1.with_name(std::move($3))); }
@@ -154,6 +172,10 @@ BINARY: ATOMIC_EXPRESSION plus ATOMIC_EXPRESSION
         { $$ = { std::move($1), BinaryOperator::Multiply, std::move($3), @$ }; }
       | ATOMIC_EXPRESSION div ATOMIC_EXPRESSION
         { $$ = { std::move($1), BinaryOperator::Divide, std::move($3), @$ }; }
+      | ATOMIC_EXPRESSION mod ATOMIC_EXPRESSION
+        { $$ = { std::move($1), BinaryOperator::Modulo, std::move($3), @$ }; }
+      | ATOMIC_EXPRESSION pow ATOMIC_EXPRESSION
+        { $$ = { std::move($1), BinaryOperator::Power, std::move($3), @$ }; }
 
 COMPARISON_OP: equal_equal    { $$ = ComparisonOperator::Equal; }
              | not_equal      { $$ = ComparisonOperator::NotEqual; }
@@ -218,6 +240,10 @@ FUNCTION_DEFINITION: function IDENTIFIER FUNCTION_BODY
 
 ARGUMENTS: lparen EXPRESSION_LIST rparen { $$ = std::move($2); }
 
+// Records
+RECORD_DEFINITION: record IDENTIFIER lparen NAME_LIST rparen
+                   { $$ = { std::move($2), std::move($4), @$ }; }
+
 // Control Flow
 IF_BASE: _if EXPRESSION then BLOCK { $$ = { std::move($2), std::move($4), @$ }; }
 
@@ -297,6 +323,7 @@ STATEMENT: ASSIGNMENT           { $$ = { std::move($1) }; }
          | IF_STATEMENT         { $$ = { std::move($1) }; }
          | FUNCTION_CALL        { $$ = { std::move($1) }; }
          | FUNCTION_DEFINITION  { $$ = { std::move($1) }; }
+         | RECORD_DEFINITION    { $$ = { std::move($1) }; }
          | WHILE                { $$ = { std::move($1) }; }
          | error                { $$ = {}; yynerrs_++; }
 
@@ -0,0 +1,409 @@
+module l3.runtime;
+
+namespace l3::runtime {
+
+namespace {
+
+using Limb = BigInt::Limb;
+using Magnitude = std::vector<Limb>;
+using Digits = std::span<const Limb>;
+
+constexpr std::size_t LIMB_BITS = 32;
+constexpr std::uint64_t LIMB_MASK = 0xFFFF'FFFF;
+constexpr std::uint64_t BASE = 1ULL << LIMB_BITS;
+// Below this many limbs in the shorter operand, schoolbook multiplication is
+// faster than the additions of Karatsuba
+constexpr std::size_t KARATSUBA_THRESHOLD = 32;
+
+void trim(Magnitude &digits) {
+  while (!digits.empty() && digits.back() == 0) {
+    digits.pop_back();
+  }
+}
+
+Digits trimmed(Digits digits) {
+  while (!digits.empty() && digits.back() == 0) {
+    digits = digits.first(digits.size() - 1);
+  }
+  return digits;
+}
+
+std::strong_ordering compare_magnitude(Digits lhs, Digits rhs) {
+  if (lhs.size() != rhs.size()) {
+    return lhs.size() <=> rhs.size();
+  }
+  for (auto i = lhs.size(); i-- > 0;) {
+    if (lhs[i] != rhs[i]) {
+      return lhs[i] <=> rhs[i];
+    }
+  }
+  return std::strong_ordering::equal;
+}
+
+// `target += digits << (shift * LIMB_BITS)`
+void add_shifted(Magnitude &target, Digits digits, std::size_t shift) {
+  if (digits.empty()) {
+    return;
+  }
+  if (target.size() < digits.size() + shift) {
+    target.resize(digits.size() + shift);
+  }
+  std::uint64_t carry = 0;
+  auto i = shift;
+  for (const auto digit : digits) {
+    carry += std::uint64_t{target[i]} + digit;
+    target[i++] = static_cast<Limb>(carry);
+    carry >>= LIMB_BITS;
+  }
+  for (; carry != 0; ++i) {
+    if (i == target.size()) {
+      target.push_back(0);
+    }
+    carry += target[i];
+    target[i] = static_cast<Limb>(carry);
+    carry >>= LIMB_BITS;
+  }
+}
+
+// `target -= digits`, which must not be larger than `target`
+void subtract_in_place(Magnitude &target, Digits digits) {
+  std::int64_t borrow = 0;
+  std::size_t i = 0;
+  for (; i < digits.size(); ++i) {
+    const auto difference = std::int64_t{target[i]} - digits[i] - borrow;
+    target[i] = static_cast<Limb>(difference);
+    borrow = difference < 0 ? 1 : 0;
+  }
+  for (; borrow != 0; ++i) {
+    const auto difference = std::int64_t{target[i]} - borrow;
+    target[i] = static_cast<Limb>(difference);
+    borrow = difference < 0 ? 1 : 0;
+  }
+  trim(target);
+}
+
+Magnitude multiply_schoolbook(Digits lhs, Digits rhs) {
+  Magnitude result(lhs.size() + rhs.size());
+  for (std::size_t i = 0; i < lhs.size(); ++i) {
+    std::uint64_t carry = 0;
+    for (std::size_t j = 0; j < rhs.size(); ++j) {
+      carry += (std::uint64_t{lhs[i]} * rhs[j]) + result[i + j];
+      result[i + j] = static_cast<Limb>(carry);
+      carry >>= LIMB_BITS;
+    }
+    result[i + rhs.size()] = static_cast<Limb>(carry);
+  }
+  trim(result);
+  return result;
+}
+
+Magnitude multiply(Digits lhs, Digits rhs) {
+  lhs = trimmed(lhs);
+  rhs = trimmed(rhs);
+  if (lhs.size() < rhs.size()) {
+    std::swap(lhs, rhs);
+  }
+  if (rhs.size() < KARATSUBA_THRESHOLD) {
+    return multiply_schoolbook(lhs, rhs);
+  }
+
+  const auto half = lhs.size() / 2;
+  const auto lhs_low = lhs.first(half);
+  const auto lhs_high = lhs.subspan(half);
+  if (rhs.size() <= half) {
+    // Unbalanced operands, only the longer one is split
+    auto result = multiply(lhs_low, rhs);
+    add_shifted(result, multiply(lhs_high, rhs), half);
+    trim(result);
+    return result;
+  }
+
+  // (a1 B + a0)(b1 B + b0) = a1 b1 B² + ((a0 + a1)(b0 + b1) - a0 b0 - a1 b1) B
+  // + a0 b0, three half-sized products instead of four
+  const auto rhs_low = rhs.first(half);
+  const auto rhs_high = rhs.subspan(half);
+  auto low = multiply(lhs_low, rhs_low);
+  const auto high = multiply(lhs_high, rhs_high);
+
+  Magnitude lhs_sum(lhs_low.begin(), lhs_low.end());
+  add_shifted(lhs_sum, lhs_high, 0);
+  Magnitude rhs_sum(rhs_low.begin(), rhs_low.end());
+  add_shifted(rhs_sum, rhs_high, 0);
+  auto middle = multiply(lhs_sum, rhs_sum);
+  subtract_in_place(middle, low);
+  subtract_in_place(middle, high);
+
+  add_shifted(low, middle, half);
+  add_shifted(low, high, 2 * half);
+  trim(low);
+  return low;
+}
+
+// Divides `digits` in place, returns the remainder
+Limb divide_in_place(Magnitude &digits, Limb divisor) {
+  std::uint64_t remainder = 0;
+  for (auto i = digits.size(); i-- > 0;) {
+    const auto current = (remainder << LIMB_BITS) | digits[i];
+    digits[i] = static_cast<Limb>(current / divisor);
+    remainder = current % divisor;
+  }
+  trim(digits);
+  return static_cast<Limb>(remainder);
+}
+
+// `digits << shift`, into `digits.size() + extra` limbs, for shifts below
+// LIMB_BITS
+Magnitude shift_left(Digits digits, std::size_t shift, std::size_t extra) {
+  Magnitude result(digits.size() + extra);
+  std::uint64_t carry = 0;
+  for (std::size_t i = 0; i < digits.size(); ++i) {
+    const auto shifted = (std::uint64_t{digits[i]} << shift) | carry;
+    result[i] = static_cast<Limb>(shifted);
+    carry = shifted >> LIMB_BITS;
+  }
+  if (extra > 0) {
+    result[digits.size()] = static_cast<Limb>(carry);
+  }
+  return result;
+}
+
+struct Division {
+  Magnitude quotient;
+  Magnitude remainder;
+};
+
+// Long division of Knuth's algorithm D, each quotient limb is estimated from
+// the two leading limbs of the remainder and corrected at most twice
+Division divide(Digits dividend, Digits divisor) {
+  if (compare_magnitude(dividend, divisor) < 0) {
+    return {.quotient = {}, .remainder = {dividend.begin(), dividend.end()}};
+  }
+  if (divisor.size() == 1) {
+    Magnitude quotient(dividend.begin(), dividend.end());
+    const auto remainder = divide_in_place(quotient, divisor.front());
+    return {
+        .quotient = std::move(quotient),
+        .remainder = remainder == 0 ? Magnitude{} : Magnitude{remainder}
+    };
+  }
+
+  // Scaled so that the leading limb of the divisor has its top bit set,
+  // which keeps the estimates close
+  const auto shift =
+      static_cast<std::size_t>(std::countl_zero(divisor.back()));
+  const auto v = shift_left(divisor, shift, 0);
+  auto u = shift_left(dividend, shift, 1);
+  const auto n = v.size();
+  const auto m = dividend.size() - n;
+
+  Magnitude quotient(m + 1);
+  for (auto j = m + 1; j-- > 0;) {
+    const auto numerator =
+        (std::uint64_t{u[j + n]} << LIMB_BITS) | u[j + n - 1];
+    auto estimate = numerator / v[n - 1];
+    auto rest = numerator % v[n - 1];
+    while (estimate >= BASE ||
+           estimate * v[n - 2] > ((rest << LIMB_BITS) | u[j + n - 2])) {
+      --estimate;
+      rest += v[n - 1];
+      if (rest >= BASE) {
+        break;
+      }
+    }
+
+    std::int64_t borrow = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      const auto product = estimate * v[i];
+      const auto difference = std::int64_t{u[i + j]} - borrow -
+                              static_cast<std::int64_t>(product & LIMB_MASK);
+      u[i + j] = static_cast<Limb>(difference);
+      borrow = static_cast<std::int64_t>(product >> LIMB_BITS) -
+               (difference >> LIMB_BITS);
+    }
+    const auto top = std::int64_t{u[j + n]} - borrow;
+    u[j + n] = static_cast<Limb>(top);
+
+    if (top < 0) {
+      // The estimate was one too large, the divisor is added back
+      --estimate;
+      std::uint64_t carry = 0;
+      for (std::size_t i = 0; i < n; ++i) {
+        carry += std::uint64_t{u[i + j]} + v[i];
+        u[i + j] = static_cast<Limb>(carry);
+        carry >>= LIMB_BITS;
+      }
+      u[j + n] = static_cast<Limb>(u[j + n] + carry);
+    }
+    quotient[j] = static_cast<Limb>(estimate);
+  }
+
+  Magnitude remainder(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    remainder[i] = static_cast<Limb>(
+        (std::uint64_t{u[i]} >> shift) |
+        (std::uint64_t{u[i + 1]} << (LIMB_BITS - shift))
+    );
+  }
+  trim(quotient);
+  trim(remainder);
+  return {.quotient = std::move(quotient), .remainder = std::move(remainder)};
+}
+
+Division divide_checked(const Magnitude &dividend, const Magnitude &divisor) {
+  if (divisor.empty()) {
+    throw UnsupportedOperation("division by zero");
+  }
+  return divide(dividend, divisor);
+}
+
+} // namespace
+
+BigInt::BigInt(std::vector<Limb> magnitude, bool negative)
+    : magnitude{std::move(magnitude)} {
+  trim(this->magnitude);
+  this->negative = negative && !this->magnitude.empty();
+}
+
+BigInt::BigInt(std::int64_t value) : negative{value < 0} {
+  // Negated as unsigned so that the smallest int does not overflow
+  auto absolute = static_cast<std::uint64_t>(value);
+  if (negative) {
+    absolute = 0 - absolute;
+  }
+  for (; absolute != 0; absolute >>= LIMB_BITS) {
+    magnitude.push_back(static_cast<Limb>(absolute));
+  }
+}
+
+BigInt BigInt::from_digits(std::string_view digits) {
+  // Converted nine decimal digits at a time, most significant first
+  constexpr std::size_t chunk_digits = 9;
+  const BigInt chunk{1'000'000'000};
+  // The first chunk takes the leftover digits, the others are full
+  auto size = digits.size() % chunk_digits;
+  if (size == 0) {
+    size = chunk_digits;
+  }
+  BigInt result;
+  for (std::size_t start = 0; start < digits.size();
+       start += std::exchange(size, chunk_digits)) {
+    std::int64_t part = 0;
+    static_cast<void>(std::from_chars(
+        digits.data() + start, digits.data() + start + size, part
+    ));
+    result = (result * chunk) + BigInt{part};
+  }
+  return result;
+}
+
+std::optional<std::int64_t> BigInt::to_int64() const {
+  if (magnitude.size() > 2) {
+    return std::nullopt;
+  }
+  std::uint64_t absolute = 0;
+  for (auto i = magnitude.size(); i-- > 0;) {
+    absolute = (absolute << LIMB_BITS) | magnitude[i];
+  }
+  constexpr auto max = std::uint64_t{std::numeric_limits<std::int64_t>::max()};
+  if (negative) {
+    if (absolute > max + 1) {
+      return std::nullopt;
+    }
+    return static_cast<std::int64_t>(0 - absolute);
+  }
+  if (absolute > max) {
+    return std::nullopt;
+  }
+  return static_cast<std::int64_t>(absolute);
+}
+
+std::string BigInt::to_string() const {
+  if (is_zero()) {
+    return "0";
+  }
+  // Converted nine decimal digits at a time, least significant first
+  constexpr Limb chunk = 1'000'000'000;
+  auto digits = magnitude;
+  std::vector<Limb> chunks;
+  while (!digits.empty()) {
+    chunks.push_back(divide_in_place(digits, chunk));
+  }
+
+  auto result = std::format("{}{}", negative ? "-" : "", chunks.back());
+  for (const auto part : chunks | std::views::reverse | std::views::drop(1)) {
+    std::format_to(std::back_inserter(result), "{:09}", part);
+  }
+  return result;
+}
+
+std::size_t BigInt::hash() const {
+  // FNV-1a over the limbs, then the sign
+  std::uint64_t result = 0xcbf29ce484222325ULL;
+  for (const auto limb : magnitude) {
+    result = (result ^ limb) * 0x100000001b3ULL;
+  }
+  return static_cast<std::size_t>(
+      result ^ static_cast<std::uint64_t>(negative)
+  );
+}
+
+BigInt BigInt::operator-() const { return {magnitude, !negative}; }
+
+BigInt operator+(const BigInt &lhs, const BigInt &rhs) {
+  if (lhs.negative == rhs.negative) {
+    auto sum = lhs.magnitude;
+    add_shifted(sum, rhs.magnitude, 0);
+    return {std::move(sum), lhs.negative};
+  }
+  // Opposite signs, the smaller magnitude is taken from the larger one
+  if (compare_magnitude(lhs.magnitude, rhs.magnitude) >= 0) {
+    auto difference = lhs.magnitude;
+    subtract_in_place(difference, rhs.magnitude);
+    return {std::move(difference), lhs.negative};
+  }
+  auto difference = rhs.magnitude;
+  subtract_in_place(difference, lhs.magnitude);
+  return {std::move(difference), rhs.negative};
+}
+
+BigInt operator-(const BigInt &lhs, const BigInt &rhs) { return lhs + -rhs; }
+
+BigInt operator*(const BigInt &lhs, const BigInt &rhs) {
+  return {multiply(lhs.magnitude, rhs.magnitude), lhs.negative != rhs.negative};
+}
+
+BigInt operator/(const BigInt &lhs, const BigInt &rhs) {
+  auto [quotient, _] = divide_checked(lhs.magnitude, rhs.magnitude);
+  return {std::move(quotient), lhs.negative != rhs.negative};
+}
+
+BigInt operator%(const BigInt &lhs, const BigInt &rhs) {
+  auto [_, remainder] = divide_checked(lhs.magnitude, rhs.magnitude);
+  return {std::move(remainder), lhs.negative};
+}
+
+BigInt BigInt::pow(std::uint64_t exponent) const {
+  BigInt result{1};
+  auto base = *this;
+  while (exponent != 0) {
+    if ((exponent & 1U) != 0) {
+      result = result * base;
+    }
+    exponent >>= 1U;
+    if (exponent != 0) {
+      base = base * base;
+    }
+  }
+  return result;
+}
+
+std::strong_ordering operator<=>(const BigInt &lhs, const BigInt &rhs) {
+  if (lhs.negative != rhs.negative) {
+    return lhs.negative ? std::strong_ordering::less
+                        : std::strong_ordering::greater;
+  }
+  const auto ordering = compare_magnitude(lhs.magnitude, rhs.magnitude);
+  return lhs.negative ? 0 <=> ordering : ordering;
+}
+
+} // namespace l3::runtime
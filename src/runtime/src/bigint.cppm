@@ -0,0 +1,60 @@
+export module l3.runtime:bigint;
+
+import std;
+
+export namespace l3::runtime {
+
+// Integer of arbitrary size, produced when integer arithmetic overflows 64
+// bits. Stored as a sign and a magnitude of 32-bit limbs, least significant
+// first, without leading zero limbs. The arithmetic of heap_data.cpp turns
+// results which fit in 64 bits back into ints, so BigInts are always larger
+// than any int in magnitude.
+class BigInt {
+public:
+  using Limb = std::uint32_t;
+
+private:
+  std::vector<Limb> magnitude;
+  bool negative = false;
+
+  BigInt(std::vector<Limb> magnitude, bool negative);
+
+public:
+  BigInt() = default;
+  explicit BigInt(std::int64_t value);
+  // Parses a non-empty string of decimal digits
+  [[nodiscard]] static BigInt from_digits(std::string_view digits);
+
+  [[nodiscard]] static std::string_view type_name() { return "int"; }
+
+  [[nodiscard]] bool is_zero() const { return magnitude.empty(); }
+  [[nodiscard]] bool is_negative() const { return negative; }
+
+  // The value as an int, when it fits in one
+  [[nodiscard]] std::optional<std::int64_t> to_int64() const;
+  [[nodiscard]] std::string to_string() const;
+  // Hash of the value, equal BigInts hash alike
+  [[nodiscard]] std::size_t hash() const;
+
+  [[nodiscard]] BigInt operator-() const;
+  friend BigInt operator+(const BigInt &lhs, const BigInt &rhs);
+  friend BigInt operator-(const BigInt &lhs, const BigInt &rhs);
+  // Karatsuba multiplication once both operands are long enough
+  friend BigInt operator*(const BigInt &lhs, const BigInt &rhs);
+  // Truncated like int division: the quotient is rounded toward zero and the
+  // remainder has the sign of the dividend
+  friend BigInt operator/(const BigInt &lhs, const BigInt &rhs);
+  friend BigInt operator%(const BigInt &lhs, const BigInt &rhs);
+  // Exponentiation by squaring
+  [[nodiscard]] BigInt pow(std::uint64_t exponent) const;
+
+  friend std::strong_ordering
+  operator<=>(const BigInt &lhs, const BigInt &rhs);
+  friend bool operator==(const BigInt &lhs, const BigInt &rhs) = default;
+
+  [[nodiscard]] std::size_t payload_bytes() const {
+    return magnitude.capacity() * sizeof(Limb);
+  }
+};
+
+} // namespace l3::runtime
@@ -5,6 +5,14 @@ import std;
 export namespace l3::runtime {
 
 template <typename T, std::size_t ChunkSize> class ChunkedAllocator {
+  template <typename, std::size_t> friend class ChunkedAllocator;
+
+  // Shared between all rebound copies of an allocator, so that the owner of a
+  // container can inspect the node allocator through get_allocator().
+  struct Stats {
+    std::size_t chunks = 0;
+  };
+
   class Chunk {
     union Inner {
       T value;
@@ -62,6 +70,17 @@ template <typename T, std::size_t ChunkSize> class ChunkedAllocator {
   mutable std::vector<std::unique_ptr<Chunk>> chunks_;
   mutable std::vector<Chunk *> free_chunks_;
   mutable Chunk *current_chunk_ = nullptr;
+  // Deallocations since empty chunks were last released. Kept per allocator,
+  // a counter shared by every allocator on a thread would make the heaps of
+  // unrelated VMs trigger each other's cleanups.
+  std::size_t cleanup_counter_ = 0;
+  std::shared_ptr<Stats> stats_ = std::make_shared<Stats>();
+
+  void update_stats() const {
+    if (stats_) {
+      stats_->chunks = chunks_.size();
+    }
+  }
 
   Chunk *get_available_chunk() const {
     if (!free_chunks_.empty()) {
@@ -75,6 +94,7 @@ template <typename T, std::size_t ChunkSize> class ChunkedAllocator {
     chunks_.emplace_back(std::make_unique<Chunk>());
     current_chunk_ = chunks_.back().get();
     free_chunks_.push_back(current_chunk_);
+    update_stats();
     return current_chunk_;
   }
 
@@ -85,6 +105,7 @@ template <typename T, std::size_t ChunkSize> class ChunkedAllocator {
 
     std::erase_if(free_chunks_, [](Chunk *chunk) { return chunk->is_empty(); });
     std::erase_if(chunks_, [](const auto &chunk) { return chunk->is_empty(); });
+    update_stats();
   }
 
 public:
@@ -103,8 +124,8 @@ public:
   ChunkedAllocator() = default;
 
   template <typename U>
-  ChunkedAllocator(const ChunkedAllocator<U, ChunkSize> & /*unused*/) noexcept {
-  }
+  ChunkedAllocator(const ChunkedAllocator<U, ChunkSize> &other) noexcept
+      : stats_(other.stats_) {}
 
   ChunkedAllocator(const ChunkedAllocator &) = delete;
   ChunkedAllocator &operator=(const ChunkedAllocator &) = delete;
@@ -131,9 +152,8 @@ public:
     for (auto &chunk : chunks_) {
       if (chunk->contains(ptr)) {
         chunk->deallocate(ptr);
-        static thread_local std::size_t cleanup_counter = 0;
-        if (++cleanup_counter >= 2 * ChunkSize) {
-          cleanup_counter = 0;
+        if (++cleanup_counter_ >= 2 * ChunkSize) {
+          cleanup_counter_ = 0;
           cleanup_empty_chunks();
         } else if (chunk->get_used() == ChunkSize - 1) {
           free_chunks_.push_back(chunk.get());
@@ -158,6 +178,10 @@ public:
 
   void cleanup() const { cleanup_empty_chunks(); }
 
+  [[nodiscard]] std::size_t chunk_count() const {
+    return stats_ ? stats_->chunks : 0;
+  }
+
   template <typename U, std::size_t OtherChunkSize>
   bool operator==(const ChunkedAllocator<U, OtherChunkSize>
                       & /*unused*/) const noexcept {
@@ -169,10 +193,11 @@ template <typename T, std::size_t ChunkSize>
 using ChunkedForwardList = std::forward_list<T, ChunkedAllocator<T, ChunkSize>>;
 
 template <typename ForwardList>
-std::size_t sweep_marked_forward_list(ForwardList &list) {
+std::size_t sweep_marked_forward_list(ForwardList &list, auto &&on_erase) {
   std::size_t erased = 0;
 
   while (!list.empty() && !list.front().is_marked()) {
+    on_erase(list.front());
     list.pop_front();
     ++erased;
   }
@@ -187,6 +212,7 @@ std::size_t sweep_marked_forward_list(ForwardList &list) {
   while (std::next(iter) != list.end()) {
     auto next = std::next(iter);
     if (!next->is_marked()) {
+      on_erase(*next);
       list.erase_after(iter);
       ++erased;
     } else {
@@ -198,4 +224,9 @@ std::size_t sweep_marked_forward_list(ForwardList &list) {
   return erased;
 }
 
+template <typename ForwardList>
+std::size_t sweep_marked_forward_list(ForwardList &list) {
+  return sweep_marked_forward_list(list, [](const auto &) {});
+}
+
 } // namespace l3::runtime
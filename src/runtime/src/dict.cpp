@@ -0,0 +1,25 @@
+module l3.runtime;
+
+namespace l3::runtime {
+
+const StackValue *Dict::find(const StackValue &key) const {
+  const auto position =
+      index.find(hash_key(key), [&](std::size_t candidate) {
+        return same_key(entries[candidate].key, key);
+      });
+  return position ? &entries[*position].value : nullptr;
+}
+
+StackValue &Dict::find_or_insert(const StackValue &key) {
+  const auto hash = hash_key(key);
+  const auto position = index.find(hash, [&](std::size_t candidate) {
+    return same_key(entries[candidate].key, key);
+  });
+  if (position) {
+    return entries[*position].value;
+  }
+  index.insert(hash);
+  return entries.emplace_back(key, StackValue{}).value;
+}
+
+} // namespace l3::runtime
@@ -0,0 +1,47 @@
+export module l3.runtime:dict;
+
+import std;
+
+import :hash_index;
+import :stack_value;
+
+export namespace l3::runtime {
+
+// Hash table from integers, BigInts, doubles, booleans and strings to values,
+// created by `{key: value}` literals. Keys are hashed and compared by content,
+// see `hash_key`. Entries are stored in insertion order and indexed by a
+// HashIndex.
+class Dict {
+public:
+  struct Entry {
+    StackValue key;
+    StackValue value;
+  };
+
+private:
+  HashIndex index;
+  std::vector<Entry> entries;
+
+public:
+  Dict() = default;
+
+  [[nodiscard]] std::size_t size() const { return entries.size(); }
+  [[nodiscard]] bool empty() const { return entries.empty(); }
+
+  // Value of `key`, or null if absent
+  [[nodiscard]] const StackValue *find(const StackValue &key) const;
+  // Value of `key`, inserting nil first if absent
+  [[nodiscard]] StackValue &find_or_insert(const StackValue &key);
+  void insert(const StackValue &key, const StackValue &value) {
+    find_or_insert(key) = value;
+  }
+
+  // Entries in insertion order
+  [[nodiscard]] std::span<const Entry> items() const { return entries; }
+
+  [[nodiscard]] std::size_t payload_bytes() const {
+    return index.payload_bytes() + (entries.capacity() * sizeof(Entry));
+  }
+};
+
+} // namespace l3::runtime
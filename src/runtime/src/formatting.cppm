@@ -2,6 +2,7 @@ export module l3.runtime:formatting;
 
 import utils;
 
+import :gc_stats;
 import :heap;
 import :heap_cell;
 import :heap_data;
@@ -50,7 +51,17 @@ export {
   struct std::formatter<l3::runtime::BytecodeFunction>
       : utils::static_formatter<l3::runtime::BytecodeFunction> {
     static constexpr auto format(const auto &obj, std::format_context &ctx) {
-      return std::format_to(ctx.out(), "function <{}>", obj.name);
+      return std::format_to(
+          ctx.out(), "function <{}>", obj.get_prototype().name
+      );
+    }
+  };
+
+  template <>
+  struct std::formatter<l3::runtime::PartialApplication>
+      : utils::static_formatter<l3::runtime::PartialApplication> {
+    static constexpr auto format(const auto &obj, std::format_context &ctx) {
+      return std::format_to(ctx.out(), "{}", obj.get_target());
     }
   };
 
@@ -80,7 +91,7 @@ export {
                 [&ctx](const l3::runtime::HeapData::function_type &f) {
                   return std::format_to(ctx.out(), "{}", *f);
                 },
-                [&ctx](const std::vector<l3::runtime::StackValue> &vec) {
+                [&ctx](const l3::runtime::Vector &vec) {
                   auto out = std::format_to(ctx.out(), "[");
                   for (std::size_t i = 0; i < vec.size(); ++i) {
                     if (i > 0)
@@ -89,8 +100,95 @@ export {
                   }
                   return std::format_to(out, "]");
                 },
-                [&ctx](const std::string &s) {
-                  return std::format_to(ctx.out(), "{}", s);
+                [&ctx](const l3::runtime::Iterator &) {
+                  return std::format_to(ctx.out(), "<iterator>");
+                },
+                [&ctx](const l3::runtime::Future &) {
+                  return std::format_to(ctx.out(), "<future>");
+                },
+                [&ctx](const l3::runtime::Range &range) {
+                  auto out = std::format_to(ctx.out(), "[");
+                  for (std::size_t i = 0; i < range.size(); ++i) {
+                    if (i > 0)
+                      out = std::format_to(out, ", ");
+                    out = std::format_to(out, "{}", range.at(i));
+                  }
+                  return std::format_to(out, "]");
+                },
+                [&ctx](const l3::runtime::GridRow &row) {
+                  auto out = std::format_to(ctx.out(), "[");
+                  for (std::size_t i = 0; i < row.size(); ++i) {
+                    if (i > 0)
+                      out = std::format_to(out, ", ");
+                    out = std::format_to(out, "{}", row[i]);
+                  }
+                  return std::format_to(out, "]");
+                },
+                [&ctx](const l3::runtime::Dict &dict) {
+                  auto out = std::format_to(ctx.out(), "{{");
+                  const auto entries = dict.items();
+                  for (std::size_t i = 0; i < entries.size(); ++i) {
+                    if (i > 0)
+                      out = std::format_to(out, ", ");
+                    out = std::format_to(
+                        out, "{}: {}", entries[i].key, entries[i].value
+                    );
+                  }
+                  return std::format_to(out, "}}");
+                },
+                [&ctx](const l3::runtime::Set &set) {
+                  // `{}` would read as an empty dict
+                  if (set.empty()) {
+                    return std::format_to(ctx.out(), "set()");
+                  }
+                  auto out = std::format_to(ctx.out(), "{{");
+                  for (std::size_t i = 0; i < set.size(); ++i) {
+                    if (i > 0)
+                      out = std::format_to(out, ", ");
+                    out = std::format_to(out, "{}", set[i]);
+                  }
+                  return std::format_to(out, "}}");
+                },
+                [&ctx](const l3::runtime::BigInt &bigint) {
+                  return std::format_to(ctx.out(), "{}", bigint.to_string());
+                },
+                [&ctx](const l3::runtime::Record &record) {
+                  const auto &fields = record.get_shape().fields;
+                  auto out = std::format_to(ctx.out(), "{}(", record.name());
+                  for (std::size_t i = 0; i < record.size(); ++i) {
+                    if (i > 0)
+                      out = std::format_to(out, ", ");
+                    out = std::format_to(out, "{}: {}", fields[i], record[i]);
+                  }
+                  return std::format_to(out, ")");
+                },
+                [&ctx](const l3::runtime::Grid &grid) {
+                  auto out = std::format_to(ctx.out(), "[");
+                  for (std::size_t i = 0; i < grid.rows(); ++i) {
+                    if (i > 0)
+                      out = std::format_to(out, ", ");
+                    out = std::format_to(out, "[");
+                    const auto row = grid.row(i);
+                    for (std::size_t j = 0; j < row.size(); ++j) {
+                      if (j > 0)
+                        out = std::format_to(out, ", ");
+                      out = std::format_to(out, "{}", row[j]);
+                    }
+                    out = std::format_to(out, "]");
+                  }
+                  return std::format_to(out, "]");
+                },
+                [&ctx](const l3::runtime::PackedArray &packed) {
+                  auto out = std::format_to(ctx.out(), "[");
+                  for (std::size_t i = 0; i < packed.size(); ++i) {
+                    if (i > 0)
+                      out = std::format_to(out, ", ");
+                    out = std::format_to(out, "{}", packed.at(i));
+                  }
+                  return std::format_to(out, "]");
+                },
+                [&ctx](const l3::runtime::String &s) {
+                  return std::format_to(ctx.out(), "{}", s.view());
                 },
                 [&ctx](const l3::runtime::Primitive &p) {
                   return std::format_to(ctx.out(), "{}", p);
@@ -113,7 +211,7 @@ export {
             return std::format_to(ctx.out(), "{}", *function);
           },
           [&ctx](const l3::runtime::HeapData::string_type &value) {
-            return std::format_to(ctx.out(), R"("{}")", value);
+            return std::format_to(ctx.out(), R"("{}")", value.view());
           },
           [&ctx](const l3::runtime::Primitive &primitive) {
             return std::format_to(ctx.out(), "{}", primitive);
@@ -130,11 +228,65 @@ export {
               out = std::format_to(out, "{}", vec[i]);
             }
             return std::format_to(out, "]");
+          },
+          [&ctx](const l3::runtime::HeapData::iterator_type &) {
+            return std::format_to(ctx.out(), "<iterator>");
+          },
+          [&ctx](const l3::runtime::HeapData::range_type &range) {
+            auto out = std::format_to(ctx.out(), "[");
+            for (std::size_t i = 0; i < range.size(); ++i) {
+              if (i > 0) {
+                out = std::format_to(out, ", ");
+              }
+              out = std::format_to(out, "{}", range.at(i));
+            }
+            return std::format_to(out, "]");
           }
       );
     }
   };
 
+  template <>
+  struct std::formatter<l3::runtime::GcStats>
+      : utils::static_formatter<l3::runtime::GcStats> {
+    static auto format(const auto &stats, std::format_context &ctx) {
+      const auto micros = [](l3::runtime::GcStats::duration value) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(value)
+            .count();
+      };
+      auto out = ctx.out();
+      out = std::format_to(out, "collections: {}\n", stats.collections);
+      out = std::format_to(
+          out,
+          "pause: {}μs total (roots {}μs, mark {}μs, sweep {}μs), max {}μs\n",
+          micros(stats.total_time()),
+          micros(stats.roots_time),
+          micros(stats.mark_time),
+          micros(stats.sweep_time),
+          micros(stats.max_pause)
+      );
+      out = std::format_to(
+          out,
+          "freed: {} cells ({} bytes), {} upvalues\n",
+          stats.cells_freed,
+          stats.bytes_freed,
+          stats.upvalues_freed
+      );
+      out = std::format_to(
+          out,
+          "surviving: {} cells, {} upvalues\n",
+          stats.cells_surviving,
+          stats.upvalues_surviving
+      );
+      return std::format_to(
+          out,
+          "chunks: {} heap, {} upvalue",
+          stats.heap_chunks,
+          stats.upvalue_chunks
+      );
+    }
+  };
+
   template <>
   struct std::formatter<l3::runtime::HeapCell>
       : utils::static_formatter<l3::runtime::HeapCell> {
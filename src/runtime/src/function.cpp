@@ -2,10 +2,66 @@ module l3.runtime;
 
 namespace l3::runtime {
 
-StackValue BuiltinFunction::invoke(L3Args args) const { return body(args); }
+BytecodeFunction::BytecodeFunction(
+    const FunctionPrototype &prototype, std::size_t upvalue_count
+)
+    : prototype{&prototype}, upvalue_count{upvalue_count} {
+  if (upvalue_count > INLINE_UPVALUES) {
+    spilled_upvalues.resize(upvalue_count);
+  }
+}
+
+std::span<UpvalueCell *const> BytecodeFunction::upvalues() const {
+  if (upvalue_count <= INLINE_UPVALUES) {
+    return std::span{inline_upvalues}.first(upvalue_count);
+  }
+  return spilled_upvalues;
+}
+
+std::span<UpvalueCell *> BytecodeFunction::upvalues() {
+  if (upvalue_count <= INLINE_UPVALUES) {
+    return std::span{inline_upvalues}.first(upvalue_count);
+  }
+  return spilled_upvalues;
+}
+
+std::size_t BytecodeFunction::payload_bytes() const {
+  return spilled_upvalues.capacity() * sizeof(UpvalueCell *);
+}
+
+PartialApplication::PartialApplication(
+    StackValue target, L3Args bound, L3Args fresh
+)
+    : target{std::move(target)}, count{bound.size() + fresh.size()} {
+  if (count > INLINE_ARGS) {
+    spilled_args.resize(count);
+  }
+  const auto out = std::ranges::copy(bound, arguments().begin()).out;
+  std::ranges::copy(fresh, out);
+}
+
+std::span<const StackValue> PartialApplication::arguments() const {
+  if (count <= INLINE_ARGS) {
+    return std::span{inline_args}.first(count);
+  }
+  return spilled_args;
+}
+
+std::span<StackValue> PartialApplication::arguments() {
+  if (count <= INLINE_ARGS) {
+    return std::span{inline_args}.first(count);
+  }
+  return spilled_args;
+}
+
+std::size_t PartialApplication::payload_bytes() const {
+  return spilled_args.capacity() * sizeof(StackValue);
+}
 
 Function::Function(BuiltinFunction &&function) : inner{std::move(function)} {}
 Function::Function(BytecodeFunction &&function) : inner{std::move(function)} {}
+Function::Function(PartialApplication &&function)
+    : inner{std::move(function)} {}
 
 utils::optional_cref<BuiltinFunction> Function::as_builtin_function() const {
   if (const auto *builtin_function = std::get_if<BuiltinFunction>(&inner)) {
@@ -14,16 +70,17 @@ utils::optional_cref<BuiltinFunction> Function::as_builtin_function() const {
   return std::nullopt;
 }
 
-utils::optional_ref<BytecodeFunction> Function::as_mut_bytecode_function() {
-  if (auto *bytecode_function = std::get_if<BytecodeFunction>(&inner)) {
+utils::optional_cref<BytecodeFunction> Function::as_bytecode_function() const {
+  if (const auto *bytecode_function = std::get_if<BytecodeFunction>(&inner)) {
     return *bytecode_function;
   }
   return std::nullopt;
 }
 
-utils::optional_cref<BytecodeFunction> Function::as_bytecode_function() const {
-  if (const auto *bytecode_function = std::get_if<BytecodeFunction>(&inner)) {
-    return *bytecode_function;
+utils::optional_cref<PartialApplication>
+Function::as_partial_application() const {
+  if (const auto *partial = std::get_if<PartialApplication>(&inner)) {
+    return *partial;
   }
   return std::nullopt;
 }
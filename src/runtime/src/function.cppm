@@ -14,47 +14,100 @@ class UpvalueCell;
 
 using L3Args = std::span<const StackValue>;
 
+// A native function, identified by its position in the builtin table. The VM
+// calling it passes itself along, so a builtin is not tied to the VM that
+// created it.
 class BuiltinFunction {
-public:
-  using Body = std::function<StackValue(L3Args)>;
-
-private:
   ast::Identifier name;
-  Body body;
+  std::size_t index;
 
 public:
-  BuiltinFunction(ast::Identifier &&name, Body body)
-      : name{std::move(name)}, body{std::move(body)} {}
-
-  [[nodiscard]] StackValue invoke(L3Args args) const;
+  BuiltinFunction(ast::Identifier &&name, std::size_t index)
+      : name{std::move(name)}, index{index} {}
 
   DEFINE_ACCESSOR_X(name);
+  DEFINE_VALUE_ACCESSOR_X(index);
 };
 
-struct BytecodeFunction {
+// What the compiler knows about a function, shared by all of its closures.
+// Prototypes belong to the program and outlive every closure over them.
+struct FunctionPrototype {
   std::size_t id;
   std::string name;
   std::size_t arity;
-  std::vector<StackValue> curried_args;
-  std::vector<UpvalueCell *> captured_upvalue_refs;
+  // Closures over it share a `mut` variable with the function that created
+  // them, so they cannot be copied into another VM
+  bool captures_mutable = false;
+};
+
+// A closure: its prototype and the upvalues it captured. Up to
+// INLINE_UPVALUES of them are stored in place, so creating a closure costs a
+// single allocation.
+class BytecodeFunction {
+public:
+  static constexpr std::size_t INLINE_UPVALUES = 4;
+
+private:
+  const FunctionPrototype *prototype;
+  std::size_t upvalue_count;
+  std::array<UpvalueCell *, INLINE_UPVALUES> inline_upvalues{};
+  std::vector<UpvalueCell *> spilled_upvalues;
+
+public:
+  explicit BytecodeFunction(
+      const FunctionPrototype &prototype, std::size_t upvalue_count = 0
+  );
+
+  [[nodiscard]] const FunctionPrototype &get_prototype() const {
+    return *prototype;
+  }
+  [[nodiscard]] std::span<UpvalueCell *const> upvalues() const;
+  [[nodiscard]] std::span<UpvalueCell *> upvalues();
+  [[nodiscard]] std::size_t payload_bytes() const;
+};
+
+// A bytecode function applied to fewer arguments than its arity. It refers to
+// the original closure instead of copying it, and partially applying it again
+// binds to that closure as well, so calls never chain through several
+// partials. Bound arguments are stored inline up to INLINE_ARGS.
+class PartialApplication {
+public:
+  static constexpr std::size_t INLINE_ARGS = 4;
+
+private:
+  StackValue target;
+  std::size_t count;
+  std::array<StackValue, INLINE_ARGS> inline_args;
+  std::vector<StackValue> spilled_args;
+
+public:
+  // `target` must hold a bytecode function, `bound` and `fresh` are bound in
+  // that order
+  PartialApplication(StackValue target, L3Args bound, L3Args fresh);
+
+  [[nodiscard]] const StackValue &get_target() const { return target; }
+  [[nodiscard]] std::span<const StackValue> arguments() const;
+  [[nodiscard]] std::span<StackValue> arguments();
+  [[nodiscard]] std::size_t payload_bytes() const;
 };
 
 class Function {
-  std::variant<BuiltinFunction, BytecodeFunction> inner;
+  std::variant<BuiltinFunction, BytecodeFunction, PartialApplication> inner;
 
 public:
   Function(BuiltinFunction &&function);
   Function(BytecodeFunction &&function);
+  Function(PartialApplication &&function);
 
   [[nodiscard]] utils::optional_cref<BuiltinFunction>
   as_builtin_function() const;
 
-  [[nodiscard]] utils::optional_ref<BytecodeFunction>
-  as_mut_bytecode_function();
-
   [[nodiscard]] utils::optional_cref<BytecodeFunction>
   as_bytecode_function() const;
 
+  [[nodiscard]] utils::optional_cref<PartialApplication>
+  as_partial_application() const;
+
   VISIT(inner);
 };
 
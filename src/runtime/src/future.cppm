@@ -0,0 +1,32 @@
+export module l3.runtime:future;
+
+import std;
+
+export namespace l3::runtime {
+
+// A task running in a VM of its own, implemented by the VM. Its result stays
+// in that VM until it is awaited.
+class Task {
+public:
+  Task() = default;
+  Task(const Task &) = delete;
+  Task(Task &&) = delete;
+  Task &operator=(const Task &) = delete;
+  Task &operator=(Task &&) = delete;
+  virtual ~Task() = default;
+
+  [[nodiscard]] virtual bool is_done() const = 0;
+};
+
+// Handle to a task, created by `spawn()` and read by `await()`. Handles are
+// never modified, so copies of one in other VMs share the task.
+class Future {
+  std::shared_ptr<Task> task;
+
+public:
+  explicit Future(std::shared_ptr<Task> task) : task{std::move(task)} {}
+
+  [[nodiscard]] const std::shared_ptr<Task> &get_task() const { return task; }
+};
+
+} // namespace l3::runtime
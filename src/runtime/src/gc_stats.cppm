@@ -0,0 +1,33 @@
+export module l3.runtime:gc_stats;
+
+import std;
+
+export namespace l3::runtime {
+
+// Cumulative garbage collector telemetry, updated by BytecodeVM::run_gc.
+struct GcStats {
+  using duration = std::chrono::nanoseconds;
+
+  std::size_t collections = 0;
+
+  duration roots_time{};
+  duration mark_time{};
+  duration sweep_time{};
+  duration max_pause{};
+
+  std::size_t cells_freed = 0;
+  std::size_t bytes_freed = 0;
+  std::size_t upvalues_freed = 0;
+
+  // Snapshot taken after the most recent collection
+  std::size_t cells_surviving = 0;
+  std::size_t upvalues_surviving = 0;
+  std::size_t heap_chunks = 0;
+  std::size_t upvalue_chunks = 0;
+
+  [[nodiscard]] duration total_time() const {
+    return roots_time + mark_time + sweep_time;
+  }
+};
+
+} // namespace l3::runtime
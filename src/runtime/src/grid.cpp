@@ -0,0 +1,76 @@
+module l3.runtime;
+
+namespace l3::runtime {
+
+Grid::Grid(
+    std::size_t height, std::size_t width, std::vector<StackValue> &&cells
+)
+    : height{height}, width{width}, cells{std::move(cells)} {}
+
+Grid::Grid(const Grid &other)
+    : height{other.height}, width{other.width}, cells{other.cells} {}
+
+Grid &Grid::operator=(const Grid &other) {
+  height = other.height;
+  width = other.width;
+  cells = other.cells;
+  row_views.clear();
+  return *this;
+}
+
+HeapCell *Grid::row_view(std::size_t index) const {
+  return index < row_views.size() ? row_views[index] : nullptr;
+}
+
+void Grid::set_row_view(std::size_t index, HeapCell *view) const {
+  if (row_views.empty()) {
+    row_views.resize(height, nullptr);
+  }
+  row_views[index] = view;
+}
+
+Grid Grid::neighbors() const {
+  // Truthiness of every cell as a byte, surrounded by a border of zeros so
+  // that the stencil below needs no bounds checks and vectorizes
+  const auto stride = width + 2;
+  std::vector<std::uint8_t> alive((height + 2) * stride, 0);
+  for (std::size_t i = 0; i < height; ++i) {
+    const auto cells_row = row(i);
+    auto *destination = alive.data() + ((i + 1) * stride) + 1;
+    for (std::size_t j = 0; j < width; ++j) {
+      destination[j] = static_cast<std::uint8_t>(cells_row[j].is_truthy());
+    }
+  }
+
+  std::vector<StackValue> counts;
+  counts.reserve(cells.size());
+  std::vector<std::uint8_t> row_counts(width);
+  for (std::size_t i = 0; i < height; ++i) {
+    const auto *above = alive.data() + (i * stride);
+    const auto *middle = above + stride;
+    const auto *below = middle + stride;
+    for (std::size_t j = 0; j < width; ++j) {
+      row_counts[j] = static_cast<std::uint8_t>(
+          above[j] + above[j + 1] + above[j + 2] + middle[j] + middle[j + 2] +
+          below[j] + below[j + 1] + below[j + 2]
+      );
+    }
+    for (const auto count : row_counts) {
+      counts.emplace_back(Primitive{static_cast<std::int64_t>(count)});
+    }
+  }
+  return {height, width, std::move(counts)};
+}
+
+GridRow::GridRow(HeapCell *grid, std::size_t index)
+    : grid{grid}, index{index} {}
+
+std::span<const StackValue> GridRow::view() const {
+  return std::get<Grid>(grid->get_value().get_inner()).row(index);
+}
+
+std::span<StackValue> GridRow::as_mut() const {
+  return std::get<Grid>(grid->get_value().get_inner()).row(index);
+}
+
+} // namespace l3::runtime
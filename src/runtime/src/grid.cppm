@@ -0,0 +1,88 @@
+export module l3.runtime:grid;
+
+import std;
+
+import :stack_value;
+
+export namespace l3::runtime {
+
+// Two dimensional array of values stored row after row in a single buffer,
+// created by `grid()`. Indexing a grid returns a view of one of its rows, so
+// `g[i][j]` reads and writes the cell in place without a vector per row.
+class Grid {
+  std::size_t height = 0;
+  std::size_t width = 0;
+  std::vector<StackValue> cells;
+  // Cells holding the view of each row, created on first access and reused
+  // by later ones. Copies of the grid start without views.
+  mutable std::vector<HeapCell *> row_views;
+
+public:
+  Grid() = default;
+  Grid(std::size_t height, std::size_t width, std::vector<StackValue> &&cells);
+
+  Grid(const Grid &other);
+  Grid(Grid &&) = default;
+  Grid &operator=(const Grid &other);
+  Grid &operator=(Grid &&) = default;
+  ~Grid() = default;
+
+  [[nodiscard]] std::size_t rows() const { return height; }
+  [[nodiscard]] std::size_t columns() const { return width; }
+  [[nodiscard]] bool empty() const { return height == 0; }
+
+  [[nodiscard]] std::span<const StackValue> row(std::size_t index) const {
+    return std::span{cells}.subspan(index * width, width);
+  }
+  [[nodiscard]] std::span<StackValue> row(std::size_t index) {
+    return std::span{cells}.subspan(index * width, width);
+  }
+  [[nodiscard]] std::span<const StackValue> values() const { return cells; }
+
+  // The cell holding the view of row `index`, or null if none exists yet
+  [[nodiscard]] HeapCell *row_view(std::size_t index) const;
+  void set_row_view(std::size_t index, HeapCell *view) const;
+
+  // Calls `fn` with the cell of every row view created so far
+  void for_each_row_view(const auto &fn) const {
+    for (auto *view : row_views) {
+      if (view != nullptr) {
+        fn(*view);
+      }
+    }
+  }
+
+  // Grid of the number of truthy cells among the eight neighbours of each
+  // cell, cells beyond the edges count as false
+  [[nodiscard]] Grid neighbors() const;
+
+  [[nodiscard]] std::size_t payload_bytes() const {
+    return (cells.capacity() * sizeof(StackValue)) +
+           (row_views.capacity() * sizeof(HeapCell *));
+  }
+};
+
+// View of one row of the grid held by `grid`, writes go to the grid
+class GridRow {
+  HeapCell *grid;
+  std::size_t index;
+
+public:
+  GridRow(HeapCell *grid, std::size_t index);
+
+  [[nodiscard]] HeapCell *get_grid() const { return grid; }
+  [[nodiscard]] std::size_t get_index() const { return index; }
+
+  [[nodiscard]] std::span<const StackValue> view() const;
+  [[nodiscard]] std::span<StackValue> as_mut() const;
+
+  [[nodiscard]] std::size_t size() const { return view().size(); }
+  [[nodiscard]] bool empty() const { return view().empty(); }
+  [[nodiscard]] const StackValue &operator[](std::size_t column) const {
+    return view()[column];
+  }
+  [[nodiscard]] auto begin() const { return view().begin(); }
+  [[nodiscard]] auto end() const { return view().end(); }
+};
+
+} // namespace l3::runtime
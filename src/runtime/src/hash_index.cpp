@@ -0,0 +1,134 @@
+module l3.runtime;
+
+namespace l3::runtime {
+
+namespace {
+
+// Finalizer of MurmurHash3, spreads every bit of `value` over the low bits
+// used as tags and the high bits used to pick groups
+constexpr std::size_t mix(std::uint64_t value) {
+  value ^= value >> 33U;
+  value *= 0xff51afd7ed558ccdULL;
+  value ^= value >> 33U;
+  value *= 0xc4ceb9fe1a85ec53ULL;
+  value ^= value >> 33U;
+  return static_cast<std::size_t>(value);
+}
+
+} // namespace
+
+std::size_t hash_key(const StackValue &key) {
+  return key.visit(
+      [](const Primitive &primitive) {
+        return primitive.visit(
+            [](const bool &value) { return mix(value ? 1 : 0); },
+            [](const std::int64_t &value) {
+              return mix(static_cast<std::uint64_t>(value));
+            },
+            [](const double &value) {
+              if (std::isnan(value)) {
+                throw ValueError("cannot hash NaN");
+              }
+              // 0.0 and -0.0 are equal and must hash alike
+              return mix(std::bit_cast<std::uint64_t>(value + 0.0));
+            }
+        );
+      },
+      [](HeapCell *cell) {
+        if (cell->is_interned()) {
+          return mix(cell->get_hash());
+        }
+        const auto &value = cell->get_value();
+        if (const auto bigint = value.as_bigint()) {
+          return mix(bigint->get().hash());
+        }
+        const auto string = value.as_string();
+        if (!string) {
+          throw TypeError("cannot hash a {} value", value.type_name());
+        }
+        // Same hash as the string table
+        return mix(std::hash<std::string_view>{}(*string));
+      },
+      [](Nil) -> std::size_t { throw TypeError("cannot hash a nil value"); }
+  );
+}
+
+bool same_key(const StackValue &lhs, const StackValue &rhs) {
+  const auto *lhs_cell = lhs.get_heap_ptr();
+  const auto *rhs_cell = rhs.get_heap_ptr();
+  if (lhs_cell != nullptr && rhs_cell != nullptr) {
+    if (lhs_cell->is_interned() && rhs_cell->is_interned()) {
+      return lhs_cell == rhs_cell;
+    }
+    const auto &lhs_value = lhs_cell->get_value();
+    const auto &rhs_value = rhs_cell->get_value();
+    // BigInts never equal an int, they are always outside the int range
+    if (const auto lhs_bigint = lhs_value.as_bigint()) {
+      const auto rhs_bigint = rhs_value.as_bigint();
+      return rhs_bigint && lhs_bigint->get() == rhs_bigint->get();
+    }
+    return lhs_value.as_string() == rhs_value.as_string();
+  }
+  const auto lhs_primitive = lhs.as_primitive();
+  const auto rhs_primitive = rhs.as_primitive();
+  if (!lhs_primitive || !rhs_primitive) {
+    return false;
+  }
+  return match::match(
+      std::forward_as_tuple(
+          lhs_primitive->get().get_inner(), rhs_primitive->get().get_inner()
+      ),
+      []<typename T>(const T &lv, const T &rv) { return lv == rv; },
+      [](const auto &, const auto &) { return false; }
+  );
+}
+
+// The loop has no early exit so that it compiles to a single vector compare
+std::uint32_t
+HashIndex::match_byte(const std::uint8_t *group, std::uint8_t byte) {
+  std::uint32_t mask = 0;
+  for (std::size_t i = 0; i < GROUP_SIZE; ++i) {
+    mask |= static_cast<std::uint32_t>(group[i] == byte) << i;
+  }
+  return mask;
+}
+
+void HashIndex::place(std::uint32_t position) {
+  const auto hash = hashes[position];
+  auto group = (hash >> TAG_BITS) & group_mask();
+  for (std::size_t probe = 1;; ++probe) {
+    const auto empty = match_byte(&control[group * GROUP_SIZE], EMPTY);
+    if (empty != 0) {
+      const auto slot = (group * GROUP_SIZE) +
+                        static_cast<std::size_t>(std::countr_zero(empty));
+      control[slot] = tag(hash);
+      slots[slot] = position;
+      return;
+    }
+    group = (group + probe) & group_mask();
+  }
+}
+
+void HashIndex::grow() {
+  const auto capacity = std::max(GROUP_SIZE, control.size() * 2);
+  control.assign(capacity, EMPTY);
+  slots.assign(capacity, 0);
+  for (std::size_t i = 0; i < hashes.size(); ++i) {
+    place(static_cast<std::uint32_t>(i));
+  }
+}
+
+std::size_t HashIndex::insert(std::size_t hash) {
+  hashes.push_back(hash);
+  const auto position = hashes.size() - 1;
+  // Grows beyond 7/8 full, as probe sequences get long past that. Growing
+  // places every entry, including the new one.
+  if (hashes.size() * 8 > control.size() * 7) {
+    grow();
+  } else {
+    place(static_cast<std::uint32_t>(position));
+  }
+  return position;
+}
+
+} // namespace l3::runtime
@@ -0,0 +1,94 @@
+export module l3.runtime:hash_index;
+
+import std;
+
+import :stack_value;
+
+export namespace l3::runtime {
+
+// Hash of a dict key or set element by content, throws for values other than
+// integers, BigInts, doubles, booleans and strings. Equal strings hash alike
+// whether or not they are interned.
+[[nodiscard]] std::size_t hash_key(const StackValue &key);
+// Equality of keys by content. Integers and doubles are distinct keys even
+// when numerically equal.
+[[nodiscard]] bool same_key(const StackValue &lhs, const StackValue &rhs);
+
+// Open-addressing index over the entries of a dict or set, which keep their
+// entries in a dense array in insertion order. Only positions in that array
+// and the hash of each entry are stored here.
+//
+// Swiss table layout: every slot has a control byte holding 7 bits of the hash
+// of its entry, and a lookup compares the control bytes of a group of slots at
+// once, only looking at entries whose byte matches.
+class HashIndex {
+public:
+  static constexpr std::size_t GROUP_SIZE = 16;
+
+private:
+  static constexpr std::uint8_t EMPTY = 0x80;
+  static constexpr std::size_t TAG_BITS = 7;
+
+  // Control bytes of the slots, either EMPTY or the tag of their entry
+  std::vector<std::uint8_t> control;
+  // Position of the entry held by each slot
+  std::vector<std::uint32_t> slots;
+  // Hash of each entry, by position
+  std::vector<std::size_t> hashes;
+
+  [[nodiscard]] static constexpr std::uint8_t tag(std::size_t hash) {
+    return static_cast<std::uint8_t>(hash & ((1U << TAG_BITS) - 1));
+  }
+  // Bit `i` is set when control byte `i` of the group equals `byte`
+  [[nodiscard]] static std::uint32_t
+  match_byte(const std::uint8_t *group, std::uint8_t byte);
+
+  [[nodiscard]] std::size_t group_mask() const {
+    return (control.size() / GROUP_SIZE) - 1;
+  }
+  void place(std::uint32_t position);
+  void grow();
+
+public:
+  [[nodiscard]] std::size_t size() const { return hashes.size(); }
+  [[nodiscard]] std::size_t hash(std::size_t position) const {
+    return hashes[position];
+  }
+
+  // Position of the entry with hash `hash` for which `is_entry` holds
+  [[nodiscard]] std::optional<std::size_t>
+  find(std::size_t hash, const auto &is_entry) const {
+    if (control.empty()) {
+      return std::nullopt;
+    }
+    auto group = (hash >> TAG_BITS) & group_mask();
+    for (std::size_t probe = 1;; ++probe) {
+      const auto *bytes = &control[group * GROUP_SIZE];
+      for (auto matches = match_byte(bytes, tag(hash)); matches != 0;
+           matches &= matches - 1) {
+        const auto slot = (group * GROUP_SIZE) +
+                          static_cast<std::size_t>(std::countr_zero(matches));
+        const auto position = slots[slot];
+        if (hashes[position] == hash && is_entry(position)) {
+          return position;
+        }
+      }
+      // The load factor keeps an empty slot in the table, so probing ends
+      if (match_byte(bytes, EMPTY) != 0) {
+        return std::nullopt;
+      }
+      group = (group + probe) & group_mask();
+    }
+  }
+
+  // Indexes a new entry with hash `hash` and returns its position, the next
+  // one in the dense array
+  std::size_t insert(std::size_t hash);
+
+  [[nodiscard]] std::size_t payload_bytes() const {
+    return control.capacity() + (slots.capacity() * sizeof(std::uint32_t)) +
+           (hashes.capacity() * sizeof(std::size_t));
+  }
+};
+
+} // namespace l3::runtime
@@ -4,25 +4,76 @@ import utils;
 
 namespace l3::runtime {
 
-Heap::Heap(bool debug) : debug{debug} {}
+Heap::Heap(bool debug) : debug{debug} {
+  constexpr auto CHARACTER_COUNT =
+      std::size_t{std::numeric_limits<unsigned char>::max()} + 1;
+
+  // Reserved up front, the string table views into the cells
+  characters.reserve(CHARACTER_COUNT);
+  for (std::size_t i = 0; i < CHARACTER_COUNT; ++i) {
+    auto &cell = characters.emplace_back(
+        HeapData{std::string(1, static_cast<char>(i))}
+    );
+    cell.make_immortal();
+    strings.insert(cell);
+  }
+}
 Heap::Heap(Heap &&) noexcept = default;
 Heap &Heap::operator=(Heap &&) noexcept = default;
 Heap::~Heap() = default;
 
 HeapCell &Heap::emplace(HeapData &&value) {
+  if (const auto string = value.as_string();
+      string && string->size() <= MAX_INTERNED_LENGTH) {
+    if (auto *cell = strings.find(*string)) {
+      return *cell;
+    }
+    auto &cell = allocate(std::move(value));
+    strings.insert(cell);
+    return cell;
+  }
+  return allocate(std::move(value));
+}
+
+HeapCell &Heap::character(char character) {
+  return characters[static_cast<unsigned char>(character)];
+}
+
+HeapCell &Heap::intern_constant(HeapCell &constant) {
+  if (auto *cell = strings.find(*constant.get_value().as_string())) {
+    return *cell;
+  }
+  strings.insert(constant);
+  return constant;
+}
+
+void Heap::release_constant(const HeapCell &constant) {
+  strings.erase(constant);
+}
+
+HeapCell &Heap::allocate(HeapData &&value) {
   size++;
   added_since_last_sweep++;
   return backing_store.emplace_front(std::move(value));
 }
 
-std::size_t Heap::sweep() {
+SweepResult Heap::sweep() {
   debug_print("[GC] Sweeping");
   sweep_count++;
-  auto erased = sweep_marked_forward_list(backing_store);
-  size -= erased;
+  strings.erase_unmarked();
+  SweepResult result;
+  result.cells = sweep_marked_forward_list(
+      backing_store,
+      [&result](const HeapCell &cell) { result.bytes += cell.footprint(); }
+  );
+  size -= result.cells;
   added_since_last_sweep = 0;
   next_gc_threshold = std::max(size * 2, std::size_t{1024});
-  return erased;
+  return result;
+}
+
+std::size_t Heap::chunk_count() const {
+  return backing_store.get_allocator().chunk_count();
 }
 
 } // namespace l3::runtime
@@ -1,12 +1,18 @@
 export module l3.runtime:heap;
 
 import :chunked_allocator;
+import :string_table;
 
 export namespace l3::runtime {
 
 class HeapCell;
 class HeapData;
 
+struct SweepResult {
+  std::size_t cells = 0;
+  std::size_t bytes = 0;
+};
+
 class Heap {
   bool debug;
   ChunkedForwardList<HeapCell, 1024> backing_store;
@@ -14,8 +20,14 @@ class Heap {
   std::size_t size = 0;
   std::size_t added_since_last_sweep = 0;
   std::size_t next_gc_threshold = 1024;
+  StringTable strings;
+  // Immortal one-byte strings, shared by all indexing into strings
+  std::vector<HeapCell> characters;
 
 public:
+  // Strings up to this length are interned when allocated
+  static constexpr std::size_t MAX_INTERNED_LENGTH = 32;
+
   Heap(bool debug = false);
 
   Heap(const Heap &) = delete;
@@ -24,10 +36,23 @@ public:
   Heap &operator=(Heap &&) noexcept;
   ~Heap();
 
-  std::size_t sweep();
+  SweepResult sweep();
+
+  [[nodiscard]] std::size_t chunk_count() const;
 
   HeapCell &emplace(HeapData &&value);
 
+  // Returns the preallocated string holding just `character`
+  [[nodiscard]] HeapCell &character(char character);
+
+  // Returns the canonical cell for a string constant, registering the constant
+  // itself if no equal string is interned yet
+  HeapCell &intern_constant(HeapCell &constant);
+  // Unregisters a constant before it is destroyed
+  void release_constant(const HeapCell &constant);
+
+  [[nodiscard]] std::size_t interned_count() const { return strings.size(); }
+
   DEFINE_VALUE_ACCESSOR_X(debug);
   DEFINE_VALUE_ACCESSOR_X(size);
   DEFINE_VALUE_ACCESSOR_X(sweep_count);
@@ -35,6 +60,8 @@ public:
   DEFINE_VALUE_ACCESSOR_X(next_gc_threshold);
 
 private:
+  HeapCell &allocate(HeapData &&value);
+
   template <typename... Ts>
   void debug_print(std::format_string<Ts...> message, Ts &&...args) const {
     if (debug) {
@@ -6,34 +6,67 @@ HeapCell::HeapCell(HeapData &&value) : value{std::move(value)} {}
 HeapCell::HeapCell(HeapCell &&other) noexcept = default;
 HeapCell &HeapCell::operator=(HeapCell &&other) noexcept = default;
 
+std::size_t HeapCell::footprint() const {
+  return sizeof(HeapCell) + value.payload_bytes();
+}
+
 void HeapCell::mark() {
-  if (marked) {
+  if (marked || immortal) {
     return;
   }
 
   marked = true;
 
-  auto mark_sv = [](StackValue &sv) {
-    if (auto *gcv = sv.get_heap_ptr()) {
-      gcv->mark();
-    }
+  auto mark_sv = [](const StackValue &sv) {
+    sv.visit([](HeapCell *gcv) { gcv->mark(); }, [](const auto &) {});
   };
 
   value.visit(
-      [&](std::vector<StackValue> &vector) {
-        for (auto &item : vector) {
+      [&](Vector &vector) {
+        // Views only keep their own range alive
+        for (const auto &item : vector) {
           mark_sv(item);
         }
       },
-      [&](Function &func) {
-        if (auto bc_opt = func.as_mut_bytecode_function()) {
-          for (auto &ca : bc_opt->get().curried_args) {
-            mark_sv(ca);
-          }
-          for (auto *uv : bc_opt->get().captured_upvalue_refs) {
-            uv->mark();
-          }
+      [&](Iterator &iterator) { iterator.for_each_value(mark_sv); },
+      [&](Grid &grid) {
+        for (const auto &cell : grid.values()) {
+          mark_sv(cell);
         }
+        grid.for_each_row_view([](HeapCell &view) { view.mark(); });
+      },
+      [](GridRow &row) { row.get_grid()->mark(); },
+      [&](Dict &dict) {
+        for (const auto &entry : dict.items()) {
+          mark_sv(entry.key);
+          mark_sv(entry.value);
+        }
+      },
+      [&](Set &set) {
+        for (const auto &element : set.items()) {
+          mark_sv(element);
+        }
+      },
+      [&](Record &record) {
+        for (const auto &field : record.items()) {
+          mark_sv(field);
+        }
+      },
+      [&](Function &func) {
+        func.visit(
+            [&](BytecodeFunction &bc_func) {
+              for (auto *uv : bc_func.upvalues()) {
+                uv->mark();
+              }
+            },
+            [&](PartialApplication &partial) {
+              mark_sv(partial.get_target());
+              for (const auto &arg : partial.arguments()) {
+                mark_sv(arg);
+              }
+            },
+            [](BuiltinFunction &) {}
+        );
       },
       [](auto &) {}
   );
@@ -7,6 +7,16 @@ export namespace l3::runtime {
 class HeapCell {
   HeapData value;
   bool marked = false;
+  // Immortal cells (compiled constants) live outside of the GC heap, are never
+  // swept and terminate marking.
+  bool immortal = false;
+  // Interned strings are unique by content within a heap, see StringTable
+  bool interned = false;
+  std::size_t hash = 0;
+  // Exclusive cells are reachable only from the local variable that OpAddAssign
+  // stored them in, so they can be appended to in place. Reading the local
+  // shares the cell.
+  bool exclusive = false;
 
 public:
   HeapCell(HeapData &&value);
@@ -18,14 +28,29 @@ public:
 
   void mark();
   void unmark() { marked = false; }
+  void make_immortal() { immortal = true; }
+  void make_exclusive() { exclusive = true; }
+  void share() { exclusive = false; }
+  void intern(std::size_t content_hash) {
+    interned = true;
+    hash = content_hash;
+  }
 
   [[nodiscard]] bool is_marked() const { return marked; }
+  [[nodiscard]] bool is_immortal() const { return immortal; }
+  [[nodiscard]] bool is_interned() const { return interned; }
+  [[nodiscard]] bool is_exclusive() const { return exclusive; }
+
+  // Approximate number of bytes owned by this cell, including its payload
+  [[nodiscard]] std::size_t footprint() const;
 
   decltype(auto) visit(this auto &&self, auto &&...visitor) {
     return self.value.visit(visitor...);
   }
 
   DEFINE_ACCESSOR_X(value);
+  // Hash of the string content, only valid for interned cells
+  DEFINE_VALUE_ACCESSOR_X(hash);
 };
 
 } // namespace l3::runtime
@@ -65,6 +65,25 @@ slice_bounds(std::size_t size, Slice slice) {
   return {start, end};
 }
 
+// Vectors, ranges, packed arrays and grid rows all behave as sequences of
+// StackValues
+template <typename T>
+concept Sequence = std::same_as<T, Vector> || std::same_as<T, Range> ||
+                   std::same_as<T, PackedArray> || std::same_as<T, GridRow>;
+
+const Vector &items(const Vector &vector) { return vector; }
+auto items(const Range &range) { return range.items(); }
+auto items(const PackedArray &packed) { return packed.items(); }
+std::span<const StackValue> items(const GridRow &row) { return row.view(); }
+
+HeapData concat(const Sequence auto &lhs, const Sequence auto &rhs) {
+  std::vector<StackValue> result;
+  result.reserve(lhs.size() + rhs.size());
+  result.append_range(items(lhs));
+  result.append_range(items(rhs));
+  return {std::move(result)};
+}
+
 template <typename T> utils::optional_cref<T> as_impl(const HeapData &v) {
   return v.visit(
       [](const T &val) -> utils::optional_cref<T> { return val; },
@@ -130,21 +149,146 @@ auto visit_pair(const StackValue &a, const StackValue &b, auto &&...handlers) {
   );
 }
 
+// Ints and BigInts are one integer type to scripts. Results which overflow
+// 64 bits are promoted to BigInts, and BigInt results which fit in 64 bits
+// are turned back into ints.
+template <typename T>
+concept Integer = std::same_as<T, Primitive> || std::same_as<T, BigInt>;
+
+HeapData from_bigint(BigInt &&value) {
+  if (const auto integer = value.to_int64()) {
+    return HeapData{Primitive{*integer}};
+  }
+  return HeapData{std::move(value)};
+}
+
+bool is_integer(const Primitive &value) { return value.is_integer(); }
+bool is_integer(const BigInt & /*value*/) { return true; }
+
+BigInt to_bigint(const Primitive &value) { return BigInt{*value.as_integer()}; }
+const BigInt &to_bigint(const BigInt &value) { return value; }
+
+// Checked operations on ints, returning whether the result overflowed like
+// the builtins they wrap
+constexpr auto checked_add = [](std::int64_t lhs,
+                                std::int64_t rhs,
+                                std::int64_t *result) {
+  return __builtin_add_overflow(lhs, rhs, result);
+};
+constexpr auto checked_sub = [](std::int64_t lhs,
+                                std::int64_t rhs,
+                                std::int64_t *result) {
+  return __builtin_sub_overflow(lhs, rhs, result);
+};
+constexpr auto checked_mul = [](std::int64_t lhs,
+                                std::int64_t rhs,
+                                std::int64_t *result) {
+  return __builtin_mul_overflow(lhs, rhs, result);
+};
+// Only the smallest int divided by -1 overflows
+constexpr auto checked_div = [](std::int64_t lhs,
+                                std::int64_t rhs,
+                                std::int64_t *result) {
+  if (rhs == 0) {
+    throw UnsupportedOperation("division by zero");
+  }
+  if (rhs == -1 && lhs == std::numeric_limits<std::int64_t>::min()) {
+    return true;
+  }
+  *result = lhs / rhs;
+  return false;
+};
+constexpr auto checked_mod = [](std::int64_t lhs,
+                                std::int64_t rhs,
+                                std::int64_t *result) {
+  if (rhs == 0) {
+    throw UnsupportedOperation("division by zero");
+  }
+  *result = rhs == -1 ? 0 : lhs % rhs;
+  return false;
+};
+
+// `lhs op rhs` on two primitives. Ints take the checked operation and are
+// computed again as BigInts when it overflows, other primitives use the
+// operator of Primitive.
+template <typename Checked, typename Op>
+HeapData primitive_op(
+    const Primitive &lhs, const Primitive &rhs, Checked checked, Op op
+) {
+  const auto *lhs_int = std::get_if<std::int64_t>(&lhs.get_inner());
+  const auto *rhs_int = std::get_if<std::int64_t>(&rhs.get_inner());
+  if (lhs_int == nullptr || rhs_int == nullptr) {
+    return {op(lhs, rhs)};
+  }
+  std::int64_t result = 0;
+  if (!checked(*lhs_int, *rhs_int, &result)) [[likely]] {
+    return {Primitive{result}};
+  }
+  return from_bigint(op(BigInt{*lhs_int}, BigInt{*rhs_int}));
+}
+
+// `lhs op rhs` when at least one operand is a BigInt
+template <typename Op> auto bigint_op(std::string_view operation, Op op) {
+  return [operation,
+          op](const Integer auto &lhs, const Integer auto &rhs) -> HeapData {
+    if (!is_integer(lhs) || !is_integer(rhs)) {
+      throw UnsupportedOperation(operation, lhs.type_name(), rhs.type_name());
+    }
+    return from_bigint(op(to_bigint(lhs), to_bigint(rhs)));
+  };
+}
+
+std::uint64_t exponent_of(const Primitive &exponent) {
+  const auto integer = exponent.as_integer();
+  if (!integer) {
+    throw UnsupportedOperation("power", "int", exponent.type_name());
+  }
+  if (*integer < 0) {
+    throw ValueError("cannot raise an int to the negative power {}", *integer);
+  }
+  return static_cast<std::uint64_t>(*integer);
+}
+
+// Exponentiation by squaring, continued on BigInts once a square or product
+// overflows
+HeapData integer_pow(std::int64_t base, const Primitive &exponent_value) {
+  const auto exponent = exponent_of(exponent_value);
+  std::int64_t result = 1;
+  auto square = base;
+  for (auto remaining = exponent;;) {
+    if ((remaining & 1U) != 0 && checked_mul(result, square, &result)) {
+      break;
+    }
+    remaining >>= 1U;
+    if (remaining == 0) {
+      return {Primitive{result}};
+    }
+    if (checked_mul(square, square, &square)) {
+      break;
+    }
+  }
+  return from_bigint(BigInt{base}.pow(exponent));
+}
+
 template <typename T> HeapData add_op(const T &a, const T &b) {
   return visit_pair(
       a,
       b,
       [](const Primitive &lhs, const Primitive &rhs) -> HeapData {
-        return {lhs + rhs};
+        return primitive_op(lhs, rhs, checked_add, std::plus{});
+      },
+      bigint_op("addition", std::plus{}),
+      [](const String &ls, const String &rs) -> HeapData {
+        return {String::concat(ls, rs.view())};
       },
-      [](const std::string &ls, const std::string &rs) -> HeapData {
-        return {ls + rs};
+      [](const PackedArray &lv, const PackedArray &rv) -> HeapData {
+        if (auto packed = PackedArray::concat(lv, rv)) {
+          return {std::move(*packed)};
+        }
+        return concat(lv, rv);
       },
-      [](const std::vector<StackValue> &lv,
-         const std::vector<StackValue> &rv) -> HeapData {
-        auto result = lv;
-        result.append_range(rv);
-        return {std::move(result)};
+      [](const Sequence auto &lv, const Sequence auto &rv) -> HeapData {
+        return concat(lv, rv);
       },
       [&](const auto &, const auto &) -> HeapData {
         throw UnsupportedOperation("addition", a.type_name(), b.type_name());
@@ -157,8 +301,9 @@ template <typename T> HeapData sub_op(const T &a, const T &b) {
       a,
       b,
       [](const Primitive &lhs, const Primitive &rhs) -> HeapData {
-        return {lhs - rhs};
+        return primitive_op(lhs, rhs, checked_sub, std::minus{});
       },
+      bigint_op("subtraction", std::minus{}),
       [&](const auto &, const auto &) -> HeapData {
         throw UnsupportedOperation("subtraction", a.type_name(), b.type_name());
       }
@@ -170,17 +315,24 @@ template <typename T> HeapData mul_op(const T &a, const T &b) {
       a,
       b,
       [](const Primitive &lhs, const Primitive &rhs) -> HeapData {
-        return {lhs * rhs};
+        return primitive_op(lhs, rhs, checked_mul, std::multiplies{});
+      },
+      bigint_op("multiplication", std::multiplies{}),
+      [](const Primitive &count, const Sequence auto &seq) -> HeapData {
+        return multiply_container(
+            items(seq) | std::ranges::to<std::vector>(), count
+        );
       },
-      [](const Primitive &count, const std::vector<StackValue> &vec)
-          -> HeapData { return multiply_container(vec, count); },
-      [](const Primitive &count, const std::string &str) -> HeapData {
-        return multiply_container(str, count);
+      [](const Primitive &count, const String &str) -> HeapData {
+        return multiply_container(std::string{str.view()}, count);
       },
-      [](const std::vector<StackValue> &vec, const Primitive &count)
-          -> HeapData { return multiply_container(vec, count); },
-      [](const std::string &str, const Primitive &count) -> HeapData {
-        return multiply_container(str, count);
+      [](const Sequence auto &seq, const Primitive &count) -> HeapData {
+        return multiply_container(
+            items(seq) | std::ranges::to<std::vector>(), count
+        );
+      },
+      [](const String &str, const Primitive &count) -> HeapData {
+        return multiply_container(std::string{str.view()}, count);
       },
       [&](const auto &, const auto &) -> HeapData {
         throw UnsupportedOperation(
@@ -195,8 +347,9 @@ template <typename T> HeapData div_op(const T &a, const T &b) {
       a,
       b,
       [](const Primitive &lhs, const Primitive &rhs) -> HeapData {
-        return {lhs / rhs};
+        return primitive_op(lhs, rhs, checked_div, std::divides{});
       },
+      bigint_op("division", std::divides{}),
       [&](const auto &, const auto &) -> HeapData {
         throw UnsupportedOperation("division", a.type_name(), b.type_name());
       }
@@ -208,8 +361,9 @@ template <typename T> HeapData mod_op(const T &a, const T &b) {
       a,
       b,
       [](const Primitive &lhs, const Primitive &rhs) -> HeapData {
-        return {lhs % rhs};
+        return primitive_op(lhs, rhs, checked_mod, std::modulus{});
       },
+      bigint_op("modulo", std::modulus{}),
       [&](const auto &, const auto &) -> HeapData {
         throw UnsupportedOperation("modulo", a.type_name(), b.type_name());
       }
@@ -221,22 +375,21 @@ template <typename T> HeapData pow_op(const T &a, const T &b) {
       a,
       b,
       [](const Primitive &lhs, const Primitive &rhs) -> HeapData {
-        return HeapData{match::match(
+        return match::match(
             std::forward_as_tuple(lhs.get_inner(), rhs.get_inner()),
-            [](std::int64_t base, std::int64_t exp) -> Primitive {
-              std::int64_t result = 1;
-              for (std::int64_t i = 0; i < exp; ++i) {
-                result *= base;
-              }
-              return Primitive{result};
+            [&rhs](std::int64_t base, std::int64_t) -> HeapData {
+              return integer_pow(base, rhs);
             },
-            [](double base, double exp) -> Primitive {
-              return Primitive{std::pow(base, exp)};
+            [](double base, double exp) -> HeapData {
+              return {Primitive{std::pow(base, exp)}};
             },
-            [](const auto &, const auto &) -> Primitive {
+            [](const auto &, const auto &) -> HeapData {
               throw UnsupportedOperation("power not supported for these types");
             }
-        )};
+        );
+      },
+      [](const BigInt &base, const Primitive &exponent) -> HeapData {
+        return from_bigint(base.pow(exponent_of(exponent)));
       },
       [&](const auto &, const auto &) -> HeapData {
         throw UnsupportedOperation("power", a.type_name(), b.type_name());
@@ -247,7 +400,13 @@ template <typename T> HeapData pow_op(const T &a, const T &b) {
 template <typename T> HeapData negative_op(const T &v) {
   return visit_flat(
       v,
-      [](const Primitive &p) -> HeapData { return {-p}; },
+      [](const Primitive &p) -> HeapData {
+        if (p.as_integer() == std::numeric_limits<std::int64_t>::min()) {
+          return {-BigInt{*p.as_integer()}};
+        }
+        return {-p};
+      },
+      [](const BigInt &value) -> HeapData { return from_bigint(-value); },
       [&](const auto &) -> HeapData {
         throw UnsupportedOperation("cannot negate a {} value", v.type_name());
       }
@@ -261,12 +420,83 @@ template <typename T> std::partial_ordering compare_op(const T &a, const T &b) {
       []<typename U>(const U &lhs, const U &rhs) -> std::partial_ordering
         requires requires(U lhs, U rhs) { lhs <=> rhs; }
       { return lhs <=> rhs; },
-      [](const std::vector<StackValue> &lv,
-         const std::vector<StackValue> &rv) -> std::partial_ordering {
+      [](const Grid &lg, const Grid &rg) -> std::partial_ordering {
+        if (lg.rows() != rg.rows()) {
+          return lg.rows() <=> rg.rows();
+        }
+        if (lg.columns() != rg.columns()) {
+          return lg.columns() <=> rg.columns();
+        }
+        for (const auto [el, er] : std::views::zip(lg.values(), rg.values())) {
+          const auto elem_cmp = compare_op(el, er);
+          if (elem_cmp != std::partial_ordering::equivalent) {
+            return elem_cmp;
+          }
+        }
+        return std::partial_ordering::equivalent;
+      },
+      [](const Set &ls, const Set &rs) -> std::partial_ordering {
+        // Sets are equal or unordered
+        if (ls.size() != rs.size()) {
+          return std::partial_ordering::unordered;
+        }
+        for (const auto &element : ls.items()) {
+          if (!rs.contains(element)) {
+            return std::partial_ordering::unordered;
+          }
+        }
+        return std::partial_ordering::equivalent;
+      },
+      [](const BigInt &lhs, const Primitive &rhs) -> std::partial_ordering {
+        if (const auto integer = rhs.as_integer()) {
+          return lhs <=> BigInt{*integer};
+        }
+        return std::partial_ordering::unordered;
+      },
+      [](const Primitive &lhs, const BigInt &rhs) -> std::partial_ordering {
+        if (const auto integer = lhs.as_integer()) {
+          return BigInt{*integer} <=> rhs;
+        }
+        return std::partial_ordering::unordered;
+      },
+      [](const Record &lr, const Record &rr) -> std::partial_ordering {
+        // Records are equal or unordered
+        if (!lr.has_shape(&rr.get_shape())) {
+          return std::partial_ordering::unordered;
+        }
+        for (const auto [el, er] : std::views::zip(lr.items(), rr.items())) {
+          if (compare_op(el, er) != std::partial_ordering::equivalent) {
+            return std::partial_ordering::unordered;
+          }
+        }
+        return std::partial_ordering::equivalent;
+      },
+      [](const Dict &ld, const Dict &rd) -> std::partial_ordering {
+        // Dicts are equal or unordered
+        if (ld.size() != rd.size()) {
+          return std::partial_ordering::unordered;
+        }
+        for (const auto &entry : ld.items()) {
+          const auto *value = rd.find(entry.key);
+          if (value == nullptr || compare_op(entry.value, *value) !=
+                                      std::partial_ordering::equivalent) {
+            return std::partial_ordering::unordered;
+          }
+        }
+        return std::partial_ordering::equivalent;
+      },
+      [](const Sequence auto &lv,
+         const Sequence auto &rv) -> std::partial_ordering {
+        if constexpr (std::same_as<std::decay_t<decltype(lv)>, PackedArray> &&
+                      std::same_as<std::decay_t<decltype(rv)>, PackedArray>) {
+          if (const auto ordering = lv.compare(rv)) {
+            return *ordering;
+          }
+        }
         if (lv.size() != rv.size()) {
           return lv.size() <=> rv.size();
         }
-        for (const auto [el, er] : std::views::zip(lv, rv)) {
+        for (const auto [el, er] : std::views::zip(items(lv), items(rv))) {
           const auto elem_cmp = compare_op(el, er);
           if (elem_cmp != std::partial_ordering::equivalent) {
             return elem_cmp;
@@ -285,8 +515,18 @@ template <typename T> bool is_truthy_op(const T &v) {
       v,
       [](const Primitive &p) { return p.is_truthy(); },
       [](Nil) { return false; },
-      [](const std::string &s) { return !s.empty(); },
-      [](const std::vector<StackValue> &vec) { return !vec.empty(); },
+      [](const String &s) { return !s.empty(); },
+      [](const Vector &vec) { return !vec.empty(); },
+      [](const Range &range) { return !range.empty(); },
+      [](const PackedArray &packed) { return !packed.empty(); },
+      [](const Grid &grid) { return !grid.empty(); },
+      [](const GridRow &row) { return !row.empty(); },
+      [](const Dict &dict) { return !dict.empty(); },
+      [](const Set &set) { return !set.empty(); },
+      [](const Record &) { return true; },
+      [](const BigInt &value) { return !value.is_zero(); },
+      [](const Iterator &) { return true; },
+      [](const Future &) { return true; },
       [](const auto &) -> bool {
         throw TypeError(
             "cannot convert a function to bool, did you mean to call the "
@@ -303,8 +543,18 @@ template <typename T> std::string_view type_name_op(const T &v) {
       [](const Primitive &p) { return p.type_name(); },
       [](Nil) { return "nil"sv; },
       [](const std::unique_ptr<Function> &) { return "function"sv; },
-      [](const std::vector<StackValue> &) { return "vector"sv; },
-      [](const std::string &) { return "string"sv; }
+      [](const Vector &) { return "vector"sv; },
+      [](const Range &) { return "vector"sv; },
+      [](const PackedArray &) { return "vector"sv; },
+      [](const Grid &) { return "grid"sv; },
+      [](const GridRow &) { return "vector"sv; },
+      [](const Dict &) { return "dict"sv; },
+      [](const Set &) { return "set"sv; },
+      [](const Record &record) { return record.name(); },
+      [](const BigInt &) { return BigInt::type_name(); },
+      [](const Iterator &) { return "iterator"sv; },
+      [](const Future &) { return "future"sv; },
+      [](const String &) { return "string"sv; }
   );
 }
 
@@ -313,9 +563,18 @@ template <typename T> HeapData not_op_impl(const T &v) {
       v,
       [](const Primitive &p) -> HeapData { return {!p}; },
       [](Nil) -> HeapData { return {Primitive{true}}; },
-      [](const std::string &s) -> HeapData { return {Primitive{s.empty()}}; },
-      [](const std::vector<StackValue> &vec) -> HeapData {
-        return {Primitive{vec.empty()}};
+      [](const String &s) -> HeapData { return {Primitive{s.empty()}}; },
+      [](const Sequence auto &seq) -> HeapData {
+        return {Primitive{seq.empty()}};
+      },
+      [](const Iterator &) -> HeapData { return {Primitive{false}}; },
+      [](const Future &) -> HeapData { return {Primitive{false}}; },
+      [](const Grid &grid) -> HeapData { return {Primitive{grid.empty()}}; },
+      [](const Dict &dict) -> HeapData { return {Primitive{dict.empty()}}; },
+      [](const Set &set) -> HeapData { return {Primitive{set.empty()}}; },
+      [](const Record &) -> HeapData { return {Primitive{false}}; },
+      [](const BigInt &value) -> HeapData {
+        return {Primitive{value.is_zero()}};
       },
       [](const auto &) -> HeapData {
         throw TypeError(
@@ -356,17 +615,37 @@ HeapData::HeapData(const Function &function)
 HeapData::HeapData(Function &&function)
     : inner{std::make_unique<Function>(std::move(function))} {}
 HeapData::HeapData(vector_type &&vector) : inner{std::move(vector)} {}
+HeapData::HeapData(std::vector<StackValue> &&vector)
+    : inner{Vector{std::move(vector)}} {}
 HeapData::HeapData(string_type &&string) : inner{std::move(string)} {}
+HeapData::HeapData(std::string &&string) : inner{String{std::move(string)}} {}
+HeapData::HeapData(range_type range) : inner{range} {}
+HeapData::HeapData(iterator_type &&iterator) : inner{std::move(iterator)} {}
+HeapData::HeapData(packed_type &&packed) : inner{std::move(packed)} {}
+HeapData::HeapData(grid_type &&grid) : inner{std::move(grid)} {}
+HeapData::HeapData(grid_row_type row) : inner{row} {}
+HeapData::HeapData(dict_type &&dict) : inner{std::move(dict)} {}
+HeapData::HeapData(set_type &&set) : inner{std::move(set)} {}
+HeapData::HeapData(record_type &&record) : inner{std::move(record)} {}
+HeapData::HeapData(bigint_type &&bigint) : inner{std::move(bigint)} {}
+HeapData::HeapData(future_type &&future) : inner{std::move(future)} {}
 
 HeapData HeapData::add(const HeapData &other) const {
   return add_op(*this, other);
 }
 void HeapData::add_assign(const HeapData &other) {
+  if (is_primitive() || is_bigint()) {
+    // Integer sums may change between ints and BigInts
+    *this = add(other);
+    return;
+  }
+  materialize();
   match::match(
       std::forward_as_tuple(inner, other.inner),
-      [](Primitive &lhs, const Primitive &rhs) { lhs = lhs + rhs; },
-      [](vector_type &lv, const vector_type &rv) { lv.append_range(rv); },
-      [](string_type &ls, const string_type &rs) { ls.append_range(rs); },
+      [](vector_type &lv, const Sequence auto &rv) {
+        lv.as_mut().append_range(items(rv));
+      },
+      [](string_type &ls, const string_type &rs) { ls.append(rs.view()); },
       [&other, this](auto &, const auto &) {
         throw UnsupportedOperation("addition", type_name(), other.type_name());
       }
@@ -399,6 +678,15 @@ bool HeapData::is_function() const { return is_impl<function_type>(*this); }
 bool HeapData::is_primitive() const { return is_impl<Primitive>(*this); }
 bool HeapData::is_vector() const { return is_impl<vector_type>(*this); }
 bool HeapData::is_string() const { return is_impl<string_type>(*this); }
+bool HeapData::is_range() const { return is_impl<range_type>(*this); }
+bool HeapData::is_iterator() const { return is_impl<iterator_type>(*this); }
+bool HeapData::is_packed() const { return is_impl<packed_type>(*this); }
+bool HeapData::is_grid() const { return is_impl<grid_type>(*this); }
+bool HeapData::is_dict() const { return is_impl<dict_type>(*this); }
+bool HeapData::is_set() const { return is_impl<set_type>(*this); }
+bool HeapData::is_record() const { return is_impl<record_type>(*this); }
+bool HeapData::is_bigint() const { return is_impl<bigint_type>(*this); }
+bool HeapData::is_future() const { return is_impl<future_type>(*this); }
 
 utils::optional_cref<Primitive> HeapData::as_primitive() const {
   return as_impl<Primitive>(*this);
@@ -408,27 +696,113 @@ utils::optional_cref<HeapData::vector_type> HeapData::as_vector() const {
   return as_impl<vector_type>(*this);
 }
 
-utils::optional_ref<HeapData::vector_type> HeapData::as_mut_vector() {
-  return as_mut_impl<vector_type>(*this);
+utils::optional_ref<std::vector<StackValue>> HeapData::as_mut_vector() {
+  materialize();
+  return as_mut_impl<vector_type>(*this).transform([](auto vector) {
+    return std::ref(vector.get().as_mut());
+  });
 }
 
-utils::optional_cref<HeapData::string_type> HeapData::as_string() const {
-  return as_impl<string_type>(*this);
+std::optional<std::string_view> HeapData::as_string() const {
+  return as_impl<string_type>(*this).transform([](const auto &string) {
+    return string.get().view();
+  });
 }
 
-HeapData HeapData::slice(Slice slice) const {
+utils::optional_cref<HeapData::range_type> HeapData::as_range() const {
+  return as_impl<range_type>(*this);
+}
+
+utils::optional_cref<HeapData::packed_type> HeapData::as_packed() const {
+  return as_impl<packed_type>(*this);
+}
+
+utils::optional_cref<HeapData::grid_type> HeapData::as_grid() const {
+  return as_impl<grid_type>(*this);
+}
+
+utils::optional_cref<HeapData::grid_row_type> HeapData::as_grid_row() const {
+  return as_impl<grid_row_type>(*this);
+}
+
+utils::optional_cref<HeapData::dict_type> HeapData::as_dict() const {
+  return as_impl<dict_type>(*this);
+}
+
+utils::optional_cref<HeapData::set_type> HeapData::as_set() const {
+  return as_impl<set_type>(*this);
+}
+
+utils::optional_cref<HeapData::record_type> HeapData::as_record() const {
+  return as_impl<record_type>(*this);
+}
+
+utils::optional_cref<HeapData::bigint_type> HeapData::as_bigint() const {
+  return as_impl<bigint_type>(*this);
+}
+
+utils::optional_cref<HeapData::future_type> HeapData::as_future() const {
+  return as_impl<future_type>(*this);
+}
+
+void HeapData::materialize() {
+  if (const auto *range = std::get_if<range_type>(&inner)) {
+    inner = Vector{range->materialize()};
+  } else if (const auto *packed = std::get_if<packed_type>(&inner)) {
+    inner = Vector{packed->materialize()};
+  }
+}
+
+HeapData HeapData::slice(Slice slice, HeapCell *owner) const {
   return visit(
-      [slice](const vector_type &vector) -> HeapData {
+      [slice, owner](const vector_type &vector) -> HeapData {
         const auto [start, end] = slice_bounds(vector.size(), slice);
-        return {
-            HeapData::vector_type(vector.begin() + start, vector.begin() + end)
-        };
+        if (owner != nullptr) {
+          // `vector` is the owner's value, which may turn into a view of the
+          // buffer shared with the slice
+          auto &self = std::get<Vector>(owner->get_value().get_inner());
+          return {Vector::slice(
+              self,
+              static_cast<std::size_t>(start),
+              static_cast<std::size_t>(end)
+          )};
+        }
+        return {std::vector<StackValue>(
+            vector.begin() + start, vector.begin() + end
+        )};
       },
-      [slice](const string_type &string) -> HeapData {
+      [slice, owner](const string_type &string) -> HeapData {
         const auto [start, end] = slice_bounds(string.size(), slice);
-        return {string.substr(
-            static_cast<HeapData::string_type::size_type>(start),
-            static_cast<HeapData::string_type::size_type>(end - start)
+        // Constants are never turned into shared strings, their slices copy
+        if (owner != nullptr && !owner->is_immortal()) {
+          auto &self = std::get<String>(owner->get_value().get_inner());
+          return {String::slice(
+              self,
+              static_cast<std::size_t>(start),
+              static_cast<std::size_t>(end)
+          )};
+        }
+        return {std::string{string.view().substr(
+            static_cast<std::size_t>(start),
+            static_cast<std::size_t>(end - start)
+        )}};
+      },
+      [slice](const range_type &range) -> HeapData {
+        const auto [start, end] = slice_bounds(range.size(), slice);
+        return {range.slice(
+            static_cast<std::size_t>(start), static_cast<std::size_t>(end)
+        )};
+      },
+      [slice](const grid_row_type &row) -> HeapData {
+        const auto [start, end] = slice_bounds(row.size(), slice);
+        return {std::vector<StackValue>(
+            row.begin() + start, row.begin() + end
+        )};
+      },
+      [slice](const packed_type &packed) -> HeapData {
+        const auto [start, end] = slice_bounds(packed.size(), slice);
+        return {packed.slice(
+            static_cast<std::size_t>(start), static_cast<std::size_t>(end)
         )};
       },
       [this](const auto &) -> HeapData {
@@ -450,6 +824,46 @@ HeapData HeapData::negative() const {
 
 std::string_view HeapData::type_name() const { return type_name_op(*this); }
 
+std::size_t HeapData::payload_bytes() const {
+  return visit(
+      [](const function_type &function) -> std::size_t {
+        return sizeof(Function) +
+               function->visit(
+                   [](const BuiltinFunction &) { return 0UZ; },
+                   [](const BytecodeFunction &bc_func) {
+                     return bc_func.payload_bytes();
+                   },
+                   [](const PartialApplication &partial) {
+                     return partial.payload_bytes();
+                   }
+               );
+      },
+      [](const vector_type &vector) -> std::size_t {
+        return vector.payload_bytes();
+      },
+      [](const string_type &string) -> std::size_t {
+        return string.payload_bytes();
+      },
+      [](const packed_type &packed) -> std::size_t {
+        return packed.payload_bytes();
+      },
+      [](const grid_type &grid) -> std::size_t {
+        return grid.payload_bytes();
+      },
+      [](const dict_type &dict) -> std::size_t {
+        return dict.payload_bytes();
+      },
+      [](const set_type &set) -> std::size_t { return set.payload_bytes(); },
+      [](const record_type &record) -> std::size_t {
+        return record.payload_bytes();
+      },
+      [](const bigint_type &bigint) -> std::size_t {
+        return bigint.payload_bytes();
+      },
+      [](const auto &) -> std::size_t { return 0; }
+  );
+}
+
 bool StackValue::is_truthy() const { return is_truthy_op(*this); }
 
 std::string_view StackValue::type_name() const { return type_name_op(*this); }
@@ -463,11 +877,33 @@ HeapData to_owned(const StackValue &sv) {
             [](const std::unique_ptr<Function> &f) -> HeapData {
               return HeapData{*f};
             },
-            [](const std::vector<StackValue> &v) -> HeapData {
-              return HeapData{std::vector<StackValue>(v)};
+            [](const Vector &v) -> HeapData {
+              return HeapData{std::vector<StackValue>(v.begin(), v.end())};
+            },
+            [](const String &s) -> HeapData {
+              return HeapData{std::string{s.view()}};
             },
-            [](const std::string &s) -> HeapData {
-              return HeapData{std::string(s)};
+            [](const Range &r) -> HeapData { return HeapData{r}; },
+            [](const PackedArray &packed) -> HeapData {
+              return HeapData{PackedArray{packed}};
+            },
+            [](const Grid &grid) -> HeapData { return HeapData{Grid{grid}}; },
+            [](const GridRow &row) -> HeapData {
+              return HeapData{std::vector<StackValue>(row.begin(), row.end())};
+            },
+            [](const Dict &dict) -> HeapData { return HeapData{Dict{dict}}; },
+            [](const Set &set) -> HeapData { return HeapData{Set{set}}; },
+            [](const Record &record) -> HeapData {
+              return HeapData{Record{record}};
+            },
+            [](const BigInt &bigint) -> HeapData {
+              return HeapData{BigInt{bigint}};
+            },
+            [](const Iterator &it) -> HeapData {
+              return HeapData{Iterator{it}};
+            },
+            [](const Future &future) -> HeapData {
+              return HeapData{Future{future}};
             },
             [](Primitive p) -> HeapData { return HeapData{p}; },
             [](Nil) -> HeapData { return {}; }
@@ -486,11 +922,48 @@ HeapData negative(const StackValue &sv) { return negative_op(sv); }
 HeapData not_op(const StackValue &sv) { return not_op_impl(sv); }
 
 std::partial_ordering compare(const StackValue &a, const StackValue &b) {
+  const auto *lhs = a.get_heap_ptr();
+  if (lhs != nullptr && lhs == b.get_heap_ptr() && lhs->is_interned()) {
+    return std::partial_ordering::equivalent;
+  }
   return compare_op(a, b);
 }
 
+bool equals(const StackValue &a, const StackValue &b) {
+  const auto *lhs = a.get_heap_ptr();
+  const auto *rhs = b.get_heap_ptr();
+  if (lhs != nullptr && rhs != nullptr) {
+    if (lhs->is_interned() && rhs->is_interned()) {
+      return lhs == rhs;
+    }
+    const auto lhs_string = lhs->get_value().as_string();
+    const auto rhs_string = rhs->get_value().as_string();
+    if (lhs_string && rhs_string) {
+      return *lhs_string == *rhs_string;
+    }
+  }
+  return compare_op(a, b) == std::partial_ordering::equivalent;
+}
+
+void add_assign(HeapData &target, const StackValue &value) {
+  value.visit(
+      [&target](HeapCell *cell) {
+        target.add_assign(cell->get_value());
+      },
+      [&target](const auto &flat) { target.add_assign(HeapData{flat}); }
+  );
+}
+
 StackValue
 index(const StackValue &container, const StackValue &index_sv, Heap &heap) {
+  if (const auto dict = container.as_dict()) {
+    const auto *value = dict->get().find(index_sv);
+    if (value == nullptr) {
+      throw ValueError("key {} not found in dict", index_sv);
+    }
+    return *value;
+  }
+
   const auto index_opt =
       index_sv.as_primitive().and_then(&Primitive::as_integer);
   if (!index_opt) {
@@ -503,17 +976,46 @@ index(const StackValue &container, const StackValue &index_sv, Heap &heap) {
 
   return visit_flat(
       container,
-      [&](const std::vector<StackValue> &vec) -> StackValue {
+      [&](const Vector &vec) -> StackValue {
         if (idx >= vec.size()) {
           throw ValueError("index out of bounds");
         }
         return vec[idx];
       },
-      [&](const std::string &s) -> StackValue {
+      [&](const String &s) -> StackValue {
         if (idx >= s.size()) {
           throw ValueError("index out of bounds");
         }
-        return {&heap.emplace(HeapData{std::string{s.substr(idx, 1)}})};
+        return {&heap.character(s.view()[idx])};
+      },
+      [&](const Range &range) -> StackValue {
+        if (idx >= range.size()) {
+          throw ValueError("index out of bounds");
+        }
+        return range[idx];
+      },
+      [&](const PackedArray &packed) -> StackValue {
+        if (idx >= packed.size()) {
+          throw ValueError("index out of bounds");
+        }
+        return packed[idx];
+      },
+      [&](const Grid &grid) -> StackValue {
+        if (idx >= grid.rows()) {
+          throw ValueError("index out of bounds");
+        }
+        if (auto *view = grid.row_view(idx)) {
+          return {view};
+        }
+        auto &view = heap.emplace(GridRow{container.get_heap_ptr(), idx});
+        grid.set_row_view(idx, &view);
+        return {&view};
+      },
+      [&](const GridRow &row) -> StackValue {
+        if (idx >= row.size()) {
+          throw ValueError("index out of bounds");
+        }
+        return row[idx];
       },
       [&](const auto &) -> StackValue {
         throw TypeError("cannot index a {} value", container.type_name());
@@ -521,7 +1023,34 @@ index(const StackValue &container, const StackValue &index_sv, Heap &heap) {
   );
 }
 
+StackValue element(
+    const StackValue &container, const StackValue &position, Heap &heap
+) {
+  const auto in_bounds = [&](std::size_t size) {
+    const auto position_opt =
+        position.as_primitive().and_then(&Primitive::as_integer);
+    if (!position_opt || *position_opt < 0 ||
+        std::cmp_greater_equal(*position_opt, size)) {
+      throw ValueError("index out of bounds");
+    }
+    return static_cast<std::size_t>(*position_opt);
+  };
+  if (const auto set = container.as_set()) {
+    return set->get()[in_bounds(set->get().size())];
+  }
+  if (const auto dict = container.as_dict()) {
+    return dict->get().items()[in_bounds(dict->get().size())].key;
+  }
+  return index(container, position, heap);
+}
+
 StackValue &index_mut(StackValue &container, const StackValue &index_sv) {
+  if (auto *gcv = container.get_heap_ptr()) {
+    if (auto *dict = std::get_if<Dict>(&gcv->get_value().get_inner())) {
+      return dict->find_or_insert(index_sv);
+    }
+  }
+
   const auto index_opt =
       index_sv.as_primitive().and_then(&Primitive::as_integer);
   if (!index_opt) {
@@ -536,12 +1065,22 @@ StackValue &index_mut(StackValue &container, const StackValue &index_sv) {
   if (gcv == nullptr) {
     throw TypeError("cannot index a {} value", container.type_name());
   }
+  gcv->get_value().materialize();
   return gcv->get_value().visit(
-      [&](std::vector<StackValue> &vec) -> StackValue & {
-        if (idx >= vec.size()) {
+      [&](Vector &vector) -> StackValue & {
+        if (idx >= vector.size()) {
           throw ValueError("index out of bounds");
         }
-        return vec[idx];
+        return vector.as_mut()[idx];
+      },
+      [&](const GridRow &row) -> StackValue & {
+        if (idx >= row.size()) {
+          throw ValueError("index out of bounds");
+        }
+        return row.as_mut()[idx];
+      },
+      [&](const Grid &) -> StackValue & {
+        throw TypeError("cannot assign a row of a grid, assign its cells");
       },
       [&](const auto &) -> StackValue & {
         throw TypeError("cannot index a {} value", container.type_name());
@@ -2,17 +2,38 @@ export module l3.runtime:heap_data;
 
 import utils;
 
+import :bigint;
+import :dict;
 import :function;
+import :future;
+import :grid;
+import :iterator;
+import :packed_array;
 import :primitive;
+import :range;
+import :record;
+import :set;
 import :stack_value;
+import :string;
+import :vector;
 
 export namespace l3::runtime {
 
 class HeapData {
 public:
   using function_type = std::unique_ptr<Function>;
-  using vector_type = std::vector<StackValue>;
-  using string_type = std::string;
+  using vector_type = Vector;
+  using string_type = String;
+  using range_type = Range;
+  using iterator_type = Iterator;
+  using packed_type = PackedArray;
+  using grid_type = Grid;
+  using grid_row_type = GridRow;
+  using dict_type = Dict;
+  using set_type = Set;
+  using record_type = Record;
+  using bigint_type = BigInt;
+  using future_type = Future;
 
 private:
   std::variant<
@@ -20,7 +41,17 @@ private:
       Primitive,
       std::unique_ptr<Function>,
       vector_type,
-      string_type>
+      string_type,
+      range_type,
+      iterator_type,
+      packed_type,
+      grid_type,
+      grid_row_type,
+      dict_type,
+      set_type,
+      record_type,
+      bigint_type,
+      future_type>
       inner;
 
   using variant = decltype(inner);
@@ -40,7 +71,19 @@ public:
   HeapData(const Function &function);
   HeapData(Function &&function);
   HeapData(vector_type &&vector);
+  HeapData(std::vector<StackValue> &&vector);
   HeapData(string_type &&string);
+  HeapData(std::string &&string);
+  HeapData(range_type range);
+  HeapData(iterator_type &&iterator);
+  HeapData(packed_type &&packed);
+  HeapData(grid_type &&grid);
+  HeapData(grid_row_type row);
+  HeapData(dict_type &&dict);
+  HeapData(set_type &&set);
+  HeapData(record_type &&record);
+  HeapData(bigint_type &&bigint);
+  HeapData(future_type &&future);
 
   [[nodiscard]] HeapData add(const HeapData &other) const;
   void add_assign(const HeapData &other);
@@ -65,19 +108,46 @@ public:
   [[nodiscard]] bool is_primitive() const;
   [[nodiscard]] bool is_vector() const;
   [[nodiscard]] bool is_string() const;
+  [[nodiscard]] bool is_range() const;
+  [[nodiscard]] bool is_iterator() const;
+  [[nodiscard]] bool is_packed() const;
+  [[nodiscard]] bool is_grid() const;
+  [[nodiscard]] bool is_dict() const;
+  [[nodiscard]] bool is_set() const;
+  [[nodiscard]] bool is_record() const;
+  [[nodiscard]] bool is_bigint() const;
+  [[nodiscard]] bool is_future() const;
 
   [[nodiscard]] utils::optional_cref<Primitive> as_primitive() const;
   [[nodiscard]] utils::optional_cref<vector_type> as_vector() const;
-  [[nodiscard]] utils::optional_ref<vector_type> as_mut_vector();
-  [[nodiscard]] utils::optional_cref<string_type> as_string() const;
-  [[nodiscard]] utils::optional_ref<string_type> as_mut_string();
+  // Promotes a vector view to an owned vector
+  [[nodiscard]] utils::optional_ref<std::vector<StackValue>> as_mut_vector();
+  [[nodiscard]] std::optional<std::string_view> as_string() const;
+  [[nodiscard]] utils::optional_cref<range_type> as_range() const;
+  [[nodiscard]] utils::optional_cref<packed_type> as_packed() const;
+  [[nodiscard]] utils::optional_cref<grid_type> as_grid() const;
+  [[nodiscard]] utils::optional_cref<grid_row_type> as_grid_row() const;
+  [[nodiscard]] utils::optional_cref<dict_type> as_dict() const;
+  [[nodiscard]] utils::optional_cref<set_type> as_set() const;
+  [[nodiscard]] utils::optional_cref<record_type> as_record() const;
+  [[nodiscard]] utils::optional_cref<bigint_type> as_bigint() const;
+  [[nodiscard]] utils::optional_cref<future_type> as_future() const;
+
+  // Turns a range or packed array into an owned vector of its elements, they
+  // are only materialized when mutated
+  void materialize();
 
   [[nodiscard]] bool is_truthy() const;
 
-  [[nodiscard]] HeapData slice(Slice slice) const;
+  // Slices of strings and vectors share the elements of `owner`, the cell
+  // holding this value, when one is given
+  [[nodiscard]] HeapData slice(Slice slice, HeapCell *owner = nullptr) const;
 
   [[nodiscard]] std::string_view type_name() const;
 
+  // Approximate number of bytes allocated outside of the value itself
+  [[nodiscard]] std::size_t payload_bytes() const;
+
   DEFINE_ACCESSOR_X(inner)
 };
 
@@ -89,9 +159,17 @@ public:
 [[nodiscard]] StackValue &
 index_mut(StackValue &container, const StackValue &index);
 
-// Indexing: returns StackValue directly (string substrings allocate on heap)
+// Indexing: returns StackValue directly (characters come from the heap pool)
 [[nodiscard]] StackValue
 index(const StackValue &container, const StackValue &index, class Heap &heap);
+// Element at `position` in iteration order, as read by `for` loops: keys of
+// dicts, elements of sets and `container[position]` otherwise
+[[nodiscard]] StackValue element(
+    const StackValue &container, const StackValue &position, class Heap &heap
+);
+
+// Appends `value` to `target` in place
+void add_assign(HeapData &target, const StackValue &value);
 
 // Arithmetic binary ops
 [[nodiscard]] HeapData add(const StackValue &a, const StackValue &b);
@@ -104,6 +182,8 @@ index(const StackValue &container, const StackValue &index, class Heap &heap);
 // Comparison
 [[nodiscard]] std::partial_ordering
 compare(const StackValue &a, const StackValue &b);
+// Equality, interned strings are compared by identity
+[[nodiscard]] bool equals(const StackValue &a, const StackValue &b);
 
 // Unary ops
 [[nodiscard]] HeapData negative(const StackValue &sv);
@@ -0,0 +1,77 @@
+export module l3.runtime:iterator;
+
+import std;
+
+import utils;
+
+import :stack_value;
+
+export namespace l3::runtime {
+
+// Lazy, single pass iterator produced by `iter()` and its adapters. Only
+// describes one stage of a pipeline and its position, elements are pulled by
+// the VM since adapters call functions. The inner iterator of an adapter is
+// always a cell holding another Iterator.
+class Iterator {
+public:
+  // Elements of a vector, range or string
+  struct Sequence {
+    StackValue source;
+    std::size_t position = 0;
+  };
+  struct Map {
+    StackValue function;
+    StackValue inner;
+  };
+  struct Filter {
+    StackValue function;
+    StackValue inner;
+  };
+  struct TakeWhile {
+    StackValue function;
+    StackValue inner;
+    bool done = false;
+  };
+  // Pairs of elements, ends with the shorter iterator
+  struct Zip {
+    StackValue left;
+    StackValue right;
+  };
+  // Pairs of a counter and an element
+  struct Enumerate {
+    StackValue inner;
+    std::int64_t index = 0;
+  };
+
+private:
+  std::variant<Sequence, Map, Filter, TakeWhile, Zip, Enumerate> stage;
+
+public:
+  template <typename Stage>
+    requires std::constructible_from<decltype(stage), Stage &&>
+  Iterator(Stage &&stage) : stage{std::forward<Stage>(stage)} {}
+
+  auto visit(this auto &&self, auto &&...visitor) -> decltype(auto) {
+    return match::match(
+        self.stage, std::forward<decltype(visitor)>(visitor)...
+    );
+  }
+
+  // Calls `fn` with every value the iterator keeps alive
+  void for_each_value(const auto &fn) const {
+    visit(
+        [&](const Sequence &sequence) { fn(sequence.source); },
+        [&](const Zip &zip) {
+          fn(zip.left);
+          fn(zip.right);
+        },
+        [&](const Enumerate &enumerate) { fn(enumerate.inner); },
+        [&](const auto &adapter) {
+          fn(adapter.function);
+          fn(adapter.inner);
+        }
+    );
+  }
+};
+
+} // namespace l3::runtime
@@ -0,0 +1,382 @@
+module l3.runtime;
+
+import utils;
+
+namespace l3::runtime {
+
+namespace {
+
+using Operation = PackedArray::Operation;
+
+// Elements are checked a block at a time: the loop over a block has no early
+// exit so that it vectorizes
+constexpr std::size_t KERNEL_BLOCK = 256;
+
+template <typename T>
+bool any_element(std::span<const T> elements, const auto &predicate) {
+  for (std::size_t start = 0; start < elements.size(); start += KERNEL_BLOCK) {
+    const auto block = elements.subspan(
+        start, std::min(KERNEL_BLOCK, elements.size() - start)
+    );
+    bool found = false;
+    for (const auto element : block) {
+      found |= predicate(element);
+    }
+    if (found) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename T> Primitive to_primitive(T element) {
+  if constexpr (std::same_as<T, std::uint8_t>) {
+    return Primitive{element != 0};
+  } else {
+    return Primitive{element};
+  }
+}
+
+template <typename T> void check_truthy(std::span<const T> elements) {
+  if constexpr (std::same_as<T, double>) {
+    if (!elements.empty()) {
+      // Raises the same error as a scalar double
+      static_cast<void>(Primitive{elements.front()}.is_truthy());
+    }
+  }
+}
+
+std::string_view operation_name(Operation operation) {
+  switch (operation) {
+  case Operation::Add:
+    return "addition";
+  case Operation::Subtract:
+    return "subtraction";
+  case Operation::Multiply:
+    return "multiplication";
+  case Operation::Equal:
+    return "comparison";
+  }
+  std::unreachable();
+}
+
+// `rhs` is either a span of the same length as `lhs` or a scalar
+template <typename Result, typename T, typename Rhs>
+std::vector<Result> transform_elements(
+    std::span<const T> lhs, const Rhs &rhs, const auto &operation
+) {
+  std::vector<Result> result(lhs.size());
+  for (std::size_t i = 0; i < lhs.size(); ++i) {
+    if constexpr (std::ranges::contiguous_range<Rhs>) {
+      result[i] = static_cast<Result>(operation(lhs[i], rhs[i]));
+    } else {
+      result[i] = static_cast<Result>(operation(lhs[i], rhs));
+    }
+  }
+  return result;
+}
+
+// Checked operations on ints, returning whether the result overflowed like
+// the builtins they wrap
+constexpr auto checked_add = [](std::int64_t lhs,
+                                std::int64_t rhs,
+                                std::int64_t *result) {
+  return __builtin_add_overflow(lhs, rhs, result);
+};
+constexpr auto checked_sub = [](std::int64_t lhs,
+                                std::int64_t rhs,
+                                std::int64_t *result) {
+  return __builtin_sub_overflow(lhs, rhs, result);
+};
+constexpr auto checked_mul = [](std::int64_t lhs,
+                                std::int64_t rhs,
+                                std::int64_t *result) {
+  return __builtin_mul_overflow(lhs, rhs, result);
+};
+
+// Like transform_elements, with the overflow flags of a block OR-ed together
+// so that the loop keeps no early exit. Nothing when any element overflows.
+template <typename Rhs>
+std::optional<std::vector<std::int64_t>> checked_transform_elements(
+    std::span<const std::int64_t> lhs, const Rhs &rhs, const auto &operation
+) {
+  std::vector<std::int64_t> result(lhs.size());
+  for (std::size_t start = 0; start < lhs.size(); start += KERNEL_BLOCK) {
+    const auto end = std::min(start + KERNEL_BLOCK, lhs.size());
+    bool overflow = false;
+    for (std::size_t i = start; i < end; ++i) {
+      if constexpr (std::ranges::contiguous_range<Rhs>) {
+        overflow |= operation(lhs[i], rhs[i], &result[i]);
+      } else {
+        overflow |= operation(lhs[i], rhs, &result[i]);
+      }
+    }
+    if (overflow) {
+      return std::nullopt;
+    }
+  }
+  return result;
+}
+
+template <typename T>
+std::optional<PackedArray> apply_elementwise(
+    Operation operation, std::span<const T> lhs, const auto &rhs
+) {
+  if (operation == Operation::Equal) {
+    return PackedArray{
+        transform_elements<std::uint8_t>(lhs, rhs, std::equal_to{})
+    };
+  }
+  if constexpr (std::same_as<T, std::uint8_t>) {
+    throw UnsupportedOperation(operation_name(operation), "bool", "bool");
+  } else if constexpr (std::same_as<T, std::int64_t>) {
+    const auto checked = [&](const auto &checked_operation) {
+      return checked_transform_elements(lhs, rhs, checked_operation)
+          .transform([](std::vector<std::int64_t> &&result) {
+            return PackedArray{std::move(result)};
+          });
+    };
+    switch (operation) {
+    case Operation::Add:
+      return checked(checked_add);
+    case Operation::Subtract:
+      return checked(checked_sub);
+    case Operation::Multiply:
+      return checked(checked_mul);
+    case Operation::Equal:
+      break;
+    }
+    std::unreachable();
+  } else {
+    switch (operation) {
+    case Operation::Add:
+      return PackedArray{transform_elements<T>(lhs, rhs, std::plus{})};
+    case Operation::Subtract:
+      return PackedArray{transform_elements<T>(lhs, rhs, std::minus{})};
+    case Operation::Multiply:
+      return PackedArray{transform_elements<T>(lhs, rhs, std::multiplies{})};
+    case Operation::Equal:
+      break;
+    }
+    std::unreachable();
+  }
+}
+
+// Elements bounded so that no partial sum can overflow keep the plain loop,
+// which vectorizes, others are added with an overflow check
+std::optional<std::int64_t>
+checked_sum(std::span<const std::int64_t> elements) {
+  constexpr auto max = std::numeric_limits<std::int64_t>::max();
+  const auto [low, high] = std::ranges::minmax(elements);
+  const auto bound = std::max(low == -max - 1 ? max : -low, high);
+  std::int64_t total = 0;
+  if (bound <= max / static_cast<std::int64_t>(elements.size())) {
+    for (const auto element : elements) {
+      total += element;
+    }
+    return total;
+  }
+  for (const auto element : elements) {
+    if (__builtin_add_overflow(total, element, &total)) {
+      return std::nullopt;
+    }
+  }
+  return total;
+}
+
+} // namespace
+
+PackedArray::PackedArray(Elements &&elements)
+    : elements{std::move(elements)} {}
+
+std::size_t PackedArray::size() const {
+  return visit([](const auto &elements) { return elements.size(); });
+}
+
+Primitive PackedArray::at(std::size_t index) const {
+  return visit([index](const auto &elements) {
+    return to_primitive(elements[index]);
+  });
+}
+
+std::string_view PackedArray::element_type_name() const {
+  return visit([](const auto &elements) {
+    using element_type = std::decay_t<decltype(elements)>::value_type;
+    return to_primitive(element_type{}).type_name();
+  });
+}
+
+PackedArray PackedArray::slice(std::size_t start, std::size_t end) const {
+  return visit([start, end](const auto &elements) -> PackedArray {
+    return {std::decay_t<decltype(elements)>(
+        elements.begin() + static_cast<std::ptrdiff_t>(start),
+        elements.begin() + static_cast<std::ptrdiff_t>(end)
+    )};
+  });
+}
+
+std::optional<PackedArray>
+PackedArray::concat(const PackedArray &lhs, const PackedArray &rhs) {
+  return match::match(
+      std::forward_as_tuple(lhs.elements, rhs.elements),
+      []<typename T>(const std::vector<T> &lv, const std::vector<T> &rv)
+          -> std::optional<PackedArray> {
+        std::vector<T> result;
+        result.reserve(lv.size() + rv.size());
+        result.append_range(lv);
+        result.append_range(rv);
+        return PackedArray{std::move(result)};
+      },
+      [](const auto &, const auto &) -> std::optional<PackedArray> {
+        return std::nullopt;
+      }
+  );
+}
+
+std::optional<std::partial_ordering>
+PackedArray::compare(const PackedArray &other) const {
+  return match::match(
+      std::forward_as_tuple(elements, other.elements),
+      []<typename T>(const std::vector<T> &lv, const std::vector<T> &rv)
+          -> std::optional<std::partial_ordering> {
+        if (lv.size() != rv.size()) {
+          return lv.size() <=> rv.size();
+        }
+        const auto [left, right] = std::ranges::mismatch(lv, rv);
+        if (left == lv.end()) {
+          return std::partial_ordering::equivalent;
+        }
+        return to_primitive(*left) <=> to_primitive(*right);
+      },
+      [](const auto &, const auto &) -> std::optional<std::partial_ordering> {
+        return std::nullopt;
+      }
+  );
+}
+
+std::vector<StackValue> PackedArray::materialize() const {
+  return items() | std::ranges::to<std::vector>();
+}
+
+std::optional<Primitive> PackedArray::sum() const {
+  return visit(
+      [](const std::vector<std::int64_t> &elements) {
+        return checked_sum(elements).transform([](std::int64_t total) {
+          return Primitive{total};
+        });
+      },
+      [](const auto &elements) -> std::optional<Primitive> {
+        // Doubles are added in order so that the result matches a vector,
+        // booleans raise the error of a scalar addition
+        auto total = to_primitive(elements.front());
+        for (const auto element : elements | std::views::drop(1)) {
+          total = total + to_primitive(element);
+        }
+        return total;
+      }
+  );
+}
+
+bool PackedArray::all() const {
+  return visit([]<typename T>(const std::vector<T> &elements) {
+    check_truthy<T>(elements);
+    return !any_element<T>(elements, [](T element) { return element == 0; });
+  });
+}
+
+bool PackedArray::any() const {
+  return visit([]<typename T>(const std::vector<T> &elements) {
+    check_truthy<T>(elements);
+    return any_element<T>(elements, [](T element) { return element != 0; });
+  });
+}
+
+std::size_t PackedArray::count() const {
+  return visit([]<typename T>(const std::vector<T> &elements) {
+    check_truthy<T>(elements);
+    std::size_t result = 0;
+    for (const auto element : elements) {
+      result += static_cast<std::size_t>(element != 0);
+    }
+    return result;
+  });
+}
+
+// Unboxed numbers compare in a few instructions, the branch-free partition
+// keeps mispredictions from dominating
+PackedArray PackedArray::sorted() const {
+  return visit([]<typename T>(const std::vector<T> &elements) -> PackedArray {
+    if constexpr (std::same_as<T, double>) {
+      const auto is_nan = [](T element) { return std::isnan(element); };
+      if (any_element<T>(elements, is_nan)) {
+        throw ValueError("cannot sort NaN");
+      }
+    }
+    auto result = elements;
+    utils::pdqsort<true>(result, std::ranges::less{});
+    return {std::move(result)};
+  });
+}
+
+std::optional<PackedArray> PackedArray::elementwise(
+    Operation operation, const PackedArray &lhs, const PackedArray &rhs
+) {
+  if (lhs.size() != rhs.size()) {
+    throw ValueError(
+        "elementwise {} requires arrays of the same length",
+        operation_name(operation)
+    );
+  }
+  return match::match(
+      std::forward_as_tuple(lhs.elements, rhs.elements),
+      [operation]<typename T>(
+          const std::vector<T> &lv, const std::vector<T> &rv
+      ) -> std::optional<PackedArray> {
+        return apply_elementwise<T>(
+            operation, std::span<const T>{lv}, std::span<const T>{rv}
+        );
+      },
+      [&](const auto &, const auto &) -> std::optional<PackedArray> {
+        throw UnsupportedOperation(
+            operation_name(operation),
+            lhs.element_type_name(),
+            rhs.element_type_name()
+        );
+      }
+  );
+}
+
+std::optional<PackedArray> PackedArray::elementwise(
+    Operation operation, const PackedArray &lhs, const Primitive &rhs
+) {
+  return match::match(
+      std::forward_as_tuple(lhs.elements, rhs.get_inner()),
+      [operation]<typename T>(const std::vector<T> &lv, const T &scalar)
+          -> std::optional<PackedArray> {
+        return apply_elementwise<T>(operation, std::span<const T>{lv}, scalar);
+      },
+      [operation](const std::vector<std::uint8_t> &lv, const bool &scalar)
+          -> std::optional<PackedArray> {
+        return apply_elementwise<std::uint8_t>(
+            operation,
+            std::span<const std::uint8_t>{lv},
+            static_cast<std::uint8_t>(scalar)
+        );
+      },
+      [&](const auto &, const auto &) -> std::optional<PackedArray> {
+        throw UnsupportedOperation(
+            operation_name(operation),
+            lhs.element_type_name(),
+            rhs.type_name()
+        );
+      }
+  );
+}
+
+std::size_t PackedArray::payload_bytes() const {
+  return visit([](const auto &elements) {
+    return elements.capacity() * sizeof(elements.front());
+  });
+}
+
+} // namespace l3::runtime
@@ -0,0 +1,140 @@
+export module l3.runtime:packed_array;
+
+import std;
+
+import utils;
+
+import :primitive;
+import :stack_value;
+
+export namespace l3::runtime {
+
+// Vector of integers, doubles or booleans stored unboxed. Built by `array()`
+// and by vector literals whose elements are all primitives of the same type.
+// Behaves like a vector of its elements; like ranges, the cell holding it is
+// turned into an owned vector before the first mutation.
+//
+// Reductions and elementwise operations run over the contiguous elements in
+// branch-free loops which the compiler vectorizes.
+class PackedArray {
+public:
+  // Booleans are stored as bytes so that kernels can treat them as numbers
+  template <typename T>
+  using storage_type =
+      std::conditional_t<std::same_as<T, bool>, std::uint8_t, T>;
+
+  using Elements = std::variant<
+      std::vector<std::int64_t>,
+      std::vector<double>,
+      std::vector<std::uint8_t>>;
+
+  enum class Operation : std::uint8_t { Add, Subtract, Multiply, Equal };
+
+private:
+  Elements elements;
+
+public:
+  PackedArray() = default;
+  PackedArray(Elements &&elements);
+
+  // Packs `values` when they are all primitives of the same type. Empty
+  // sequences are not packed since their element type is unknown.
+  template <std::ranges::input_range Values>
+  [[nodiscard]] static std::optional<PackedArray> pack(Values &&values) {
+    auto it = std::ranges::begin(values);
+    const auto end = std::ranges::end(values);
+    if (it == end) {
+      return std::nullopt;
+    }
+    const StackValue front = *it;
+    const auto first = front.as_primitive();
+    if (!first) {
+      return std::nullopt;
+    }
+
+    return first->get().visit(
+        [&]<typename T>(const T &) -> std::optional<PackedArray> {
+          std::vector<storage_type<T>> packed;
+          if constexpr (std::ranges::sized_range<Values>) {
+            packed.reserve(std::ranges::size(values));
+          }
+          for (; it != end; ++it) {
+            const StackValue value = *it;
+            const auto primitive = value.as_primitive();
+            if (!primitive) {
+              return std::nullopt;
+            }
+            const auto *element = std::get_if<T>(&primitive->get().get_inner());
+            if (element == nullptr) {
+              return std::nullopt;
+            }
+            packed.push_back(*element);
+          }
+          return PackedArray{std::move(packed)};
+        }
+    );
+  }
+
+  auto visit(this auto &&self, auto &&...visitor) -> decltype(auto) {
+    return match::match(
+        self.elements, std::forward<decltype(visitor)>(visitor)...
+    );
+  }
+
+  [[nodiscard]] std::size_t size() const;
+  [[nodiscard]] bool empty() const { return size() == 0; }
+
+  [[nodiscard]] Primitive at(std::size_t index) const;
+  [[nodiscard]] StackValue operator[](std::size_t index) const {
+    return {at(index)};
+  }
+
+  // Type name of the elements, as in `Primitive::type_name`
+  [[nodiscard]] std::string_view element_type_name() const;
+
+  [[nodiscard]] PackedArray slice(std::size_t start, std::size_t end) const;
+
+  // Concatenation, if both arrays hold elements of the same type
+  [[nodiscard]] static std::optional<PackedArray>
+  concat(const PackedArray &lhs, const PackedArray &rhs);
+
+  // Element by element comparison, if both arrays hold elements of the same
+  // type
+  [[nodiscard]] std::optional<std::partial_ordering>
+  compare(const PackedArray &other) const;
+
+  // The elements as a view of StackValues, computed on access
+  [[nodiscard]] auto items() const {
+    return std::views::iota(0UZ, size()) |
+           std::views::transform([this](std::size_t index) {
+             return (*this)[index];
+           });
+  }
+
+  [[nodiscard]] std::vector<StackValue> materialize() const;
+
+  // Sum of all elements, the array must not be empty. Nothing when a sum of
+  // ints overflows, which is left to the BigInt arithmetic.
+  [[nodiscard]] std::optional<Primitive> sum() const;
+  [[nodiscard]] bool all() const;
+  [[nodiscard]] bool any() const;
+  // Number of truthy elements
+  [[nodiscard]] std::size_t count() const;
+
+  // Sorted copy, ascending. Throws on NaN, which has no order.
+  [[nodiscard]] PackedArray sorted() const;
+
+  // `operation` applied to pairs of elements of arrays of the same length and
+  // type, or to each element and a scalar of the same type. Nothing when an
+  // int result overflows, which is left to the BigInt arithmetic.
+  [[nodiscard]] static std::optional<PackedArray> elementwise(
+      Operation operation, const PackedArray &lhs, const PackedArray &rhs
+  );
+  [[nodiscard]] static std::optional<PackedArray> elementwise(
+      Operation operation, const PackedArray &lhs, const Primitive &rhs
+  );
+
+  [[nodiscard]] std::size_t payload_bytes() const;
+};
+
+} // namespace l3::runtime
@@ -0,0 +1,56 @@
+module l3.runtime;
+
+namespace l3::runtime {
+
+Range::Range(std::int64_t start, std::int64_t step, std::size_t length)
+    : start{start}, step{step}, length{length} {}
+
+Range Range::between(std::int64_t start, std::int64_t end, std::int64_t step) {
+  // In 128 bits, the distance between two ints and the stride of the most
+  // negative step do not fit in an int64
+  __extension__ using int128 = __int128;
+  const auto distance =
+      step > 0 ? int128{end} - int128{start} : int128{start} - int128{end};
+  const auto stride = step > 0 ? int128{step} : -int128{step};
+  if (distance <= 0) {
+    return {start, step, 0};
+  }
+  const auto length = (distance + stride - 1) / stride;
+  // Lengths and positions are ints to scripts
+  if (length > std::numeric_limits<std::int64_t>::max()) {
+    throw ValueError("range() has more elements than an int can count");
+  }
+  return {start, step, static_cast<std::size_t>(length)};
+}
+
+Range Range::slice(std::size_t start, std::size_t end) const {
+  return {at(start), step, end - start};
+}
+
+std::optional<std::int64_t> Range::sum() const {
+  // count * start + step * count * (count - 1) / 2, in 128 bits: the terms
+  // overflow an int64 long before the sum does. Halving the even factor first
+  // keeps each product below 2^126, as count * |step| stays below 2^64.
+  __extension__ using int128 = __int128;
+  const auto count = static_cast<int128>(length);
+  const auto pairs =
+      count % 2 == 0 ? (count / 2) * (count - 1) : count * ((count - 1) / 2);
+  const auto total = (count * start) + (pairs * step);
+  if (total < std::numeric_limits<std::int64_t>::min() ||
+      total > std::numeric_limits<std::int64_t>::max()) {
+    return std::nullopt;
+  }
+  return static_cast<std::int64_t>(total);
+}
+
+BigInt Range::big_sum() const {
+  const BigInt count{static_cast<std::int64_t>(length)};
+  const auto pairs = count * (count - BigInt{1}) / BigInt{2};
+  return (count * BigInt{start}) + (pairs * BigInt{step});
+}
+
+std::vector<StackValue> Range::materialize() const {
+  return items() | std::ranges::to<std::vector>();
+}
+
+} // namespace l3::runtime
@@ -0,0 +1,63 @@
+export module l3.runtime:range;
+
+import std;
+
+import :bigint;
+import :primitive;
+import :stack_value;
+
+export namespace l3::runtime {
+
+// Lazy arithmetic sequence of integers produced by `range()`. Behaves like a
+// vector of its elements, but only stores the bounds: length, indexing and
+// slicing are O(1). The cell holding a range is turned into an owned vector
+// before the first mutation.
+class Range {
+  std::int64_t start = 0;
+  std::int64_t step = 1;
+  std::size_t length = 0;
+
+  Range(std::int64_t start, std::int64_t step, std::size_t length);
+
+public:
+  Range() = default;
+
+  // Elements from `start` up to, but excluding, `end`. Throws when there are
+  // more than the largest int.
+  [[nodiscard]] static Range
+  between(std::int64_t start, std::int64_t end, std::int64_t step);
+
+  [[nodiscard]] std::size_t size() const { return length; }
+  [[nodiscard]] bool empty() const { return length == 0; }
+
+  // Computed modulo 2^64: the offset from `start` may not fit in an int64
+  // even though the element does
+  [[nodiscard]] std::int64_t at(std::size_t index) const {
+    return static_cast<std::int64_t>(
+        static_cast<std::uint64_t>(start) +
+        (index * static_cast<std::uint64_t>(step))
+    );
+  }
+  [[nodiscard]] StackValue operator[](std::size_t index) const {
+    return {Primitive{at(index)}};
+  }
+
+  [[nodiscard]] Range slice(std::size_t start, std::size_t end) const;
+
+  // Sum of all elements in O(1), nullopt when it does not fit in an int
+  [[nodiscard]] std::optional<std::int64_t> sum() const;
+  // The same sum as a BigInt, for the sums which do not fit
+  [[nodiscard]] BigInt big_sum() const;
+
+  // The elements as a view of StackValues, computed on access
+  [[nodiscard]] auto items() const {
+    return std::views::iota(0UZ, length) |
+           std::views::transform([*this](std::size_t index) {
+             return (*this)[index];
+           });
+  }
+
+  [[nodiscard]] std::vector<StackValue> materialize() const;
+};
+
+} // namespace l3::runtime
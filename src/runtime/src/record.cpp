@@ -0,0 +1,25 @@
+module l3.runtime;
+
+namespace l3::runtime {
+
+std::optional<std::size_t> RecordShape::slot(std::string_view field) const {
+  const auto it = std::ranges::find(fields, field);
+  if (it == fields.end()) {
+    return std::nullopt;
+  }
+  return static_cast<std::size_t>(it - fields.begin());
+}
+
+Record::Record(
+    std::shared_ptr<const RecordShape> shape, std::vector<StackValue> values
+)
+    : shape{std::move(shape)}, values{std::move(values)} {}
+
+std::size_t Record::slot_of(std::string_view field) const {
+  if (const auto slot = shape->slot(field)) {
+    return *slot;
+  }
+  throw TypeError("{} has no field '{}'", shape->name, field);
+}
+
+} // namespace l3::runtime
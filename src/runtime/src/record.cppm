@@ -0,0 +1,53 @@
+export module l3.runtime:record;
+
+import std;
+
+import :stack_value;
+
+export namespace l3::runtime {
+
+// Layout shared by all instances of a `record` declaration: its name and the
+// names of its fields, in declaration order
+struct RecordShape {
+  std::string name;
+  std::vector<std::string> fields;
+
+  [[nodiscard]] std::optional<std::size_t> slot(std::string_view field) const;
+};
+
+// Instance of a record, created by calling the record name. Fields are stored
+// inline in declaration order, so the compiler can resolve a field access to
+// a slot and the VM only has to check that the shape matches.
+class Record {
+  std::shared_ptr<const RecordShape> shape;
+  std::vector<StackValue> values;
+
+public:
+  Record(
+      std::shared_ptr<const RecordShape> shape, std::vector<StackValue> values
+  );
+
+  [[nodiscard]] const RecordShape &get_shape() const { return *shape; }
+  [[nodiscard]] bool has_shape(const RecordShape *other) const {
+    return shape.get() == other;
+  }
+  [[nodiscard]] std::string_view name() const { return shape->name; }
+  [[nodiscard]] std::size_t size() const { return values.size(); }
+
+  [[nodiscard]] std::span<const StackValue> items() const { return values; }
+  [[nodiscard]] const StackValue &operator[](std::size_t slot) const {
+    return values[slot];
+  }
+  [[nodiscard]] StackValue &operator[](std::size_t slot) {
+    return values[slot];
+  }
+
+  // Slot of `field`, throws if this record has no such field
+  [[nodiscard]] std::size_t slot_of(std::string_view field) const;
+
+  [[nodiscard]] std::size_t payload_bytes() const {
+    return values.capacity() * sizeof(StackValue);
+  }
+};
+
+} // namespace l3::runtime
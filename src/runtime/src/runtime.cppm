@@ -1,11 +1,25 @@
 export module l3.runtime;
 
+export import :bigint;
+export import :dict;
 export import :error;
 export import :formatting;
 export import :function;
+export import :future;
+export import :gc_stats;
+export import :grid;
+export import :hash_index;
 export import :heap;
 export import :heap_cell;
 export import :heap_data;
+export import :iterator;
+export import :packed_array;
 export import :primitive;
+export import :range;
+export import :record;
+export import :set;
 export import :stack_value;
+export import :string;
+export import :string_table;
 export import :upvalue;
+export import :vector;
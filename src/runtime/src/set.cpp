@@ -0,0 +1,61 @@
+module l3.runtime;
+
+namespace l3::runtime {
+
+std::optional<std::size_t>
+Set::find(const StackValue &value, std::size_t hash) const {
+  return index.find(hash, [&](std::size_t candidate) {
+    return same_key(elements[candidate], value);
+  });
+}
+
+bool Set::insert(const StackValue &value, std::size_t hash) {
+  if (find(value, hash)) {
+    return false;
+  }
+  index.insert(hash);
+  elements.push_back(value);
+  return true;
+}
+
+bool Set::contains(const StackValue &value) const {
+  return find(value, hash_key(value)).has_value();
+}
+
+bool Set::insert(const StackValue &value) {
+  return insert(value, hash_key(value));
+}
+
+// The operations reuse the hashes stored in the index of their operands
+
+Set Set::unite(const Set &lhs, const Set &rhs) {
+  auto result = lhs;
+  for (std::size_t i = 0; i < rhs.size(); ++i) {
+    result.insert(rhs.elements[i], rhs.index.hash(i));
+  }
+  return result;
+}
+
+Set Set::intersect(const Set &lhs, const Set &rhs) {
+  Set result;
+  for (std::size_t i = 0; i < lhs.size(); ++i) {
+    const auto hash = lhs.index.hash(i);
+    if (rhs.find(lhs.elements[i], hash)) {
+      result.insert(lhs.elements[i], hash);
+    }
+  }
+  return result;
+}
+
+Set Set::subtract(const Set &lhs, const Set &rhs) {
+  Set result;
+  for (std::size_t i = 0; i < lhs.size(); ++i) {
+    const auto hash = lhs.index.hash(i);
+    if (!rhs.find(lhs.elements[i], hash)) {
+      result.insert(lhs.elements[i], hash);
+    }
+  }
+  return result;
+}
+
+} // namespace l3::runtime
@@ -0,0 +1,55 @@
+export module l3.runtime:set;
+
+import std;
+
+import :hash_index;
+import :stack_value;
+
+export namespace l3::runtime {
+
+// Set of integers, doubles, booleans and strings, created by `set()`.
+// Elements are hashed and compared by content like dict keys, stored in
+// insertion order and indexed by a HashIndex, so membership tests and
+// insertions take constant time.
+class Set {
+  HashIndex index;
+  std::vector<StackValue> elements;
+
+  [[nodiscard]] std::optional<std::size_t>
+  find(const StackValue &value, std::size_t hash) const;
+  bool insert(const StackValue &value, std::size_t hash);
+
+public:
+  Set() = default;
+
+  template <std::ranges::input_range Values> explicit Set(Values &&values) {
+    for (const StackValue value : values) {
+      insert(value);
+    }
+  }
+
+  [[nodiscard]] std::size_t size() const { return elements.size(); }
+  [[nodiscard]] bool empty() const { return elements.empty(); }
+
+  [[nodiscard]] bool contains(const StackValue &value) const;
+  // Adds `value`, returns whether it was absent
+  bool insert(const StackValue &value);
+
+  // Elements in insertion order
+  [[nodiscard]] std::span<const StackValue> items() const { return elements; }
+  [[nodiscard]] const StackValue &operator[](std::size_t position) const {
+    return elements[position];
+  }
+
+  // Elements of either set, of both, or of `lhs` only. Results keep the order
+  // of `lhs`, followed by the new elements of `rhs` for unions.
+  [[nodiscard]] static Set unite(const Set &lhs, const Set &rhs);
+  [[nodiscard]] static Set intersect(const Set &lhs, const Set &rhs);
+  [[nodiscard]] static Set subtract(const Set &lhs, const Set &rhs);
+
+  [[nodiscard]] std::size_t payload_bytes() const {
+    return index.payload_bytes() + (elements.capacity() * sizeof(StackValue));
+  }
+};
+
+} // namespace l3::runtime
@@ -43,20 +43,76 @@ bool StackValue::is_function() const {
   return false;
 }
 
-utils::optional_cref<std::string> StackValue::as_string() const {
+std::optional<std::string_view> StackValue::as_string() const {
   if (auto *gcv = get_heap_ptr()) {
     return gcv->get_value().as_string();
   }
   return std::nullopt;
 }
 
-utils::optional_cref<std::vector<StackValue>> StackValue::as_vector() const {
+utils::optional_cref<Vector> StackValue::as_vector() const {
   if (auto *gcv = get_heap_ptr()) {
     return gcv->get_value().as_vector();
   }
   return std::nullopt;
 }
 
+utils::optional_cref<Range> StackValue::as_range() const {
+  if (auto *gcv = get_heap_ptr()) {
+    return gcv->get_value().as_range();
+  }
+  return std::nullopt;
+}
+
+utils::optional_cref<PackedArray> StackValue::as_packed() const {
+  if (auto *gcv = get_heap_ptr()) {
+    return gcv->get_value().as_packed();
+  }
+  return std::nullopt;
+}
+
+utils::optional_cref<Grid> StackValue::as_grid() const {
+  if (auto *gcv = get_heap_ptr()) {
+    return gcv->get_value().as_grid();
+  }
+  return std::nullopt;
+}
+
+utils::optional_cref<GridRow> StackValue::as_grid_row() const {
+  if (auto *gcv = get_heap_ptr()) {
+    return gcv->get_value().as_grid_row();
+  }
+  return std::nullopt;
+}
+
+utils::optional_cref<Dict> StackValue::as_dict() const {
+  if (auto *gcv = get_heap_ptr()) {
+    return gcv->get_value().as_dict();
+  }
+  return std::nullopt;
+}
+
+utils::optional_cref<Set> StackValue::as_set() const {
+  if (auto *gcv = get_heap_ptr()) {
+    return gcv->get_value().as_set();
+  }
+  return std::nullopt;
+}
+
+utils::optional_cref<Record> StackValue::as_record() const {
+  if (auto *gcv = get_heap_ptr()) {
+    return gcv->get_value().as_record();
+  }
+  return std::nullopt;
+}
+
+utils::optional_cref<Future> StackValue::as_future() const {
+  if (auto *gcv = get_heap_ptr()) {
+    return gcv->get_value().as_future();
+  }
+  return std::nullopt;
+}
+
 utils::optional_ref<std::vector<StackValue>> StackValue::as_mut_vector() {
   if (auto *gcv = get_heap_ptr()) {
     return gcv->get_value().as_mut_vector();
@@ -65,8 +121,8 @@ utils::optional_ref<std::vector<StackValue>> StackValue::as_mut_vector() {
 }
 
 HeapData StackValue::slice(Slice slice) const {
-  if (auto *gcv = get_heap_ptr()) {
-    return gcv->get_value().slice(slice);
+  if (auto *const *gcv = std::get_if<HeapCell *>(&inner)) {
+    return (*gcv)->get_value().slice(slice, *gcv);
   }
   throw RuntimeError("slice() requires a string or vector");
 }
@@ -10,6 +10,15 @@ export namespace l3::runtime {
 
 class HeapCell;
 class HeapData;
+class Vector;
+class Range;
+class PackedArray;
+class Grid;
+class GridRow;
+class Dict;
+class Set;
+class Record;
+class Future;
 
 struct Slice {
   std::optional<std::int64_t> start, end;
@@ -70,8 +79,16 @@ public:
   [[nodiscard]] bool is_vector() const;
   [[nodiscard]] bool is_function() const;
 
-  [[nodiscard]] utils::optional_cref<std::string> as_string() const;
-  [[nodiscard]] utils::optional_cref<std::vector<StackValue>> as_vector() const;
+  [[nodiscard]] std::optional<std::string_view> as_string() const;
+  [[nodiscard]] utils::optional_cref<Vector> as_vector() const;
+  [[nodiscard]] utils::optional_cref<Range> as_range() const;
+  [[nodiscard]] utils::optional_cref<PackedArray> as_packed() const;
+  [[nodiscard]] utils::optional_cref<Grid> as_grid() const;
+  [[nodiscard]] utils::optional_cref<GridRow> as_grid_row() const;
+  [[nodiscard]] utils::optional_cref<Dict> as_dict() const;
+  [[nodiscard]] utils::optional_cref<Set> as_set() const;
+  [[nodiscard]] utils::optional_cref<Record> as_record() const;
+  [[nodiscard]] utils::optional_cref<Future> as_future() const;
   [[nodiscard]] utils::optional_ref<std::vector<StackValue>> as_mut_vector();
 
   [[nodiscard]] HeapData slice(Slice slice) const;
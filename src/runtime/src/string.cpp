@@ -0,0 +1,67 @@
+module l3.runtime;
+
+namespace l3::runtime {
+
+String::String(std::string &&string) : owned{std::move(string)} {}
+
+String::String(
+    std::shared_ptr<std::string> buffer, std::size_t offset, std::size_t length
+)
+    : shared{std::move(buffer)}, offset{offset}, length{length} {}
+
+String String::slice(String &self, std::size_t start, std::size_t end) {
+  const auto length = end - start;
+  const auto root_size = self.is_shared() ? self.shared->size() : self.size();
+
+  if (length <= MAX_COPIED_SLICE || length * MIN_VIEW_FRACTION < root_size) {
+    return {std::string{self.view().substr(start, length)}};
+  }
+
+  if (!self.is_shared()) {
+    self.length = self.owned.size();
+    self.shared = std::make_shared<std::string>(std::move(self.owned));
+    self.owned = {};
+  }
+  return {self.shared, self.offset + start, length};
+}
+
+String String::concat(const String &lhs, std::string_view rhs) {
+  // Only the string ending at the end of the buffer may grow it, any other
+  // string sharing the buffer keeps seeing just its own range
+  if (lhs.is_shared() && lhs.offset + lhs.length == lhs.shared->size()) {
+    lhs.shared->append(rhs);
+    return {lhs.shared, lhs.offset, lhs.length + rhs.size()};
+  }
+
+  const auto size = lhs.size() + rhs.size();
+  if (lhs.size() >= MIN_BUILDER_LENGTH) {
+    auto buffer = std::make_shared<std::string>();
+    buffer->reserve(2 * size);
+    buffer->append(lhs.view()).append(rhs);
+    return {std::move(buffer), 0, size};
+  }
+
+  std::string result;
+  result.reserve(size);
+  result.append(lhs.view()).append(rhs);
+  return {std::move(result)};
+}
+
+void String::append(std::string_view text) {
+  if (is_shared()) {
+    *this = concat(*this, text);
+  } else {
+    owned.append(text);
+  }
+}
+
+void String::unshare() {
+  if (is_shared()) {
+    owned = std::string{view()};
+    shared = nullptr;
+    offset = 0;
+    length = 0;
+  }
+}
+
+} // namespace l3::runtime
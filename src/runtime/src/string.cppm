@@ -0,0 +1,81 @@
+export module l3.runtime:string;
+
+import std;
+
+export namespace l3::runtime {
+
+// Immutable string value. Either owns its characters, or holds a range of a
+// buffer shared with other strings.
+//
+// Shared buffers are append-only: the offsets of every range stay valid while
+// the buffer grows, so a string ending at the end of its buffer can be
+// extended by appending to the buffer instead of copying its prefix. This
+// turns repeated `acc + x` on a large accumulator into amortized O(|x|).
+// Growing may reallocate the buffer, which invalidates views into any string
+// sharing it. Strings which are viewed for longer, like interned program
+// constants, must own their characters.
+class String {
+  std::string owned;
+  // Only set for shared strings
+  std::shared_ptr<std::string> shared;
+  std::size_t offset = 0;
+  std::size_t length = 0;
+
+  String(
+      std::shared_ptr<std::string> buffer,
+      std::size_t offset,
+      std::size_t length
+  );
+
+public:
+  // Slices up to this length are always copied
+  static constexpr std::size_t MAX_COPIED_SLICE = 32;
+  // Slices shorter than 1/N of the viewed string are copied, so that a small
+  // slice does not keep a large string alive
+  static constexpr std::size_t MIN_VIEW_FRACTION = 8;
+  // Concatenations with a left side at least this long build into a shared
+  // buffer which later concatenations can extend
+  static constexpr std::size_t MIN_BUILDER_LENGTH = 128;
+
+  String() = default;
+  String(std::string &&string);
+
+  // Returns a slice of `self`. Shares the characters of `self` unless the
+  // slice is small, in which case `self` may move its characters into a
+  // shared buffer.
+  [[nodiscard]] static String
+  slice(String &self, std::size_t start, std::size_t end);
+
+  // Returns `lhs + rhs`, extending the buffer of `lhs` in place when possible
+  [[nodiscard]] static String concat(const String &lhs, std::string_view rhs);
+
+  // Appends in place
+  void append(std::string_view text);
+  // Moves the characters of a shared string into a string of its own
+  void unshare();
+
+  [[nodiscard]] std::string_view view() const {
+    return shared != nullptr ? std::string_view{*shared}.substr(offset, length)
+                             : std::string_view{owned};
+  }
+  operator std::string_view() const { return view(); }
+
+  [[nodiscard]] std::size_t size() const {
+    return shared != nullptr ? length : owned.size();
+  }
+  [[nodiscard]] bool empty() const { return size() == 0; }
+  [[nodiscard]] bool is_shared() const { return shared != nullptr; }
+
+  // Approximate number of bytes owned by this string, shared strings are
+  // charged for their own range
+  [[nodiscard]] std::size_t payload_bytes() const {
+    return is_shared() ? length : owned.capacity();
+  }
+
+  bool operator==(const String &other) const { return view() == other.view(); }
+  std::strong_ordering operator<=>(const String &other) const {
+    return view() <=> other.view();
+  }
+};
+
+} // namespace l3::runtime
@@ -0,0 +1,38 @@
+module l3.runtime;
+
+namespace l3::runtime {
+
+HeapCell *StringTable::find(std::string_view text) const {
+  if (const auto it = cells.find(text); it != cells.end()) {
+    return it->second;
+  }
+  return nullptr;
+}
+
+void StringTable::insert(HeapCell &cell) {
+  if (!cell.is_interned()) {
+    flag_interned(cell);
+  }
+  cells.emplace(*cell.get_value().as_string(), &cell);
+}
+
+void StringTable::flag_interned(HeapCell &cell) {
+  cell.intern(std::hash<std::string_view>{}(*cell.get_value().as_string()));
+}
+
+void StringTable::erase(const HeapCell &cell) {
+  const std::string_view text = *cell.get_value().as_string();
+  if (const auto it = cells.find(text);
+      it != cells.end() && it->second == &cell) {
+    cells.erase(it);
+  }
+}
+
+void StringTable::erase_unmarked() {
+  std::erase_if(cells, [](const auto &entry) {
+    const auto *cell = entry.second;
+    return !cell->is_marked() && !cell->is_immortal();
+  });
+}
+
+} // namespace l3::runtime
@@ -0,0 +1,34 @@
+export module l3.runtime:string_table;
+
+import std;
+
+export namespace l3::runtime {
+
+class HeapCell;
+
+// Weak table of interned strings. Interned strings are unique by content, so
+// two interned cells hold equal strings if and only if they are the same cell.
+// Keys view the string stored inside the cell, so entries must be dropped
+// before their cell is freed.
+class StringTable {
+  std::unordered_map<std::string_view, HeapCell *> cells;
+
+public:
+  [[nodiscard]] HeapCell *find(std::string_view text) const;
+
+  // Registers a cell holding a string and caches its hash in the cell
+  void insert(HeapCell &cell);
+  // Flags a string cell as interned and caches its hash without registering
+  // it. Cells registered in several tables at once, like the constants of a
+  // program run by many VMs, are flagged up front so that registering them
+  // does not write to them.
+  static void flag_interned(HeapCell &cell);
+  // Unregisters a cell, unless a different cell is registered for its content
+  void erase(const HeapCell &cell);
+  // Unregisters all cells that will be freed by the upcoming sweep
+  void erase_unmarked();
+
+  [[nodiscard]] std::size_t size() const { return cells.size(); }
+};
+
+} // namespace l3::runtime
@@ -18,7 +18,9 @@ void UpvalueCell::mark() {
 }
 
 std::size_t UpvalueStorage::sweep() {
-  return sweep_marked_forward_list(backing_store);
+  const auto erased = sweep_marked_forward_list(backing_store);
+  size -= erased;
+  return erased;
 }
 
 } // namespace l3::runtime
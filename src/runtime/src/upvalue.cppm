@@ -31,6 +31,7 @@ public:
 
 class UpvalueStorage {
   ChunkedForwardList<UpvalueCell, 1024> backing_store;
+  std::size_t size = 0;
 
 public:
   UpvalueStorage() = default;
@@ -42,14 +43,22 @@ public:
   ~UpvalueStorage() = default;
 
   UpvalueCell &emplace(StackValue &&value) {
+    size++;
     return backing_store.emplace_front(std::move(value));
   }
 
   UpvalueCell &emplace(const StackValue &value) {
+    size++;
     return backing_store.emplace_front(value);
   }
 
   std::size_t sweep();
+
+  [[nodiscard]] std::size_t chunk_count() const {
+    return backing_store.get_allocator().chunk_count();
+  }
+
+  DEFINE_VALUE_ACCESSOR_X(size);
 };
 
 } // namespace l3::runtime
@@ -0,0 +1,46 @@
+module l3.runtime;
+
+namespace l3::runtime {
+
+Vector::Vector(std::vector<StackValue> &&elements)
+    : owned{std::move(elements)} {}
+
+Vector Vector::slice(Vector &self, std::size_t start, std::size_t end) {
+  const auto length = end - start;
+  const auto elements = self.view().subspan(start, length);
+
+  if (length <= MAX_COPIED_SLICE || length * MIN_VIEW_FRACTION < self.size()) {
+    return {std::vector<StackValue>(elements.begin(), elements.end())};
+  }
+
+  if (!self.is_view()) {
+    self.length = self.owned.size();
+    self.shared =
+        std::make_shared<std::vector<StackValue>>(std::move(self.owned));
+    self.owned = {};
+  }
+
+  Vector result;
+  result.shared = self.shared;
+  result.offset = self.offset + start;
+  result.length = length;
+  return result;
+}
+
+std::vector<StackValue> &Vector::as_mut() {
+  if (is_view()) {
+    if (shared.use_count() == 1 && offset == 0 && length == shared->size()) {
+      // Moving keeps the elements in place
+      owned = std::move(*shared);
+    } else {
+      const auto elements = view();
+      owned.assign(elements.begin(), elements.end());
+    }
+    shared.reset();
+    offset = 0;
+    length = 0;
+  }
+  return owned;
+}
+
+} // namespace l3::runtime
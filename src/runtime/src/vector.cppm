@@ -0,0 +1,62 @@
+export module l3.runtime:vector;
+
+import std;
+
+import :stack_value;
+
+export namespace l3::runtime {
+
+// Vector value. Either owns its elements, or views a range of a buffer shared
+// with the vector it was sliced from. Views are promoted to owned copies
+// before the first mutation, so slices never observe later writes.
+class Vector {
+  std::vector<StackValue> owned;
+  // Only set for views
+  std::shared_ptr<std::vector<StackValue>> shared;
+  std::size_t offset = 0;
+  std::size_t length = 0;
+
+public:
+  // Slices up to this length are always copied
+  static constexpr std::size_t MAX_COPIED_SLICE = 16;
+  // Slices shorter than 1/N of the sliced vector are copied, so that promoting
+  // the vector on a later write costs at most N times the skipped copy
+  static constexpr std::size_t MIN_VIEW_FRACTION = 8;
+
+  Vector() = default;
+  Vector(std::vector<StackValue> &&elements);
+
+  // Returns a slice of `self`. Shares the elements unless the slice is small,
+  // an owned `self` first moves its elements into the shared buffer.
+  [[nodiscard]] static Vector
+  slice(Vector &self, std::size_t start, std::size_t end);
+
+  [[nodiscard]] std::span<const StackValue> view() const {
+    if (shared) {
+      return std::span{*shared}.subspan(offset, length);
+    }
+    return owned;
+  }
+
+  // Returns the elements for mutation, promoting a view to an owned copy
+  [[nodiscard]] std::vector<StackValue> &as_mut();
+
+  [[nodiscard]] std::size_t size() const { return view().size(); }
+  [[nodiscard]] bool empty() const { return view().empty(); }
+  [[nodiscard]] bool is_view() const { return shared != nullptr; }
+
+  [[nodiscard]] const StackValue &operator[](std::size_t index) const {
+    return view()[index];
+  }
+  [[nodiscard]] const StackValue &front() const { return view().front(); }
+  [[nodiscard]] const StackValue &back() const { return view().back(); }
+  [[nodiscard]] auto begin() const { return view().begin(); }
+  [[nodiscard]] auto end() const { return view().end(); }
+
+  // Approximate number of bytes owned by this vector, views count their range
+  [[nodiscard]] std::size_t payload_bytes() const {
+    return (is_view() ? length : owned.capacity()) * sizeof(StackValue);
+  }
+};
+
+} // namespace l3::runtime
@@ -0,0 +1,447 @@
+export module utils:sort;
+
+import std;
+
+// Pattern-defeating quicksort, after Orson Peters' pdqsort
+// (https://github.com/orlp/pdqsort). Quicksort with a median of 3 (or ninther)
+// pivot that detects already sorted and reverse sorted runs, groups elements
+// equal to a repeated pivot, and falls back to heapsort when too many
+// partitions are unbalanced, so it never degrades to quadratic time.
+namespace utils::pdq {
+
+// Partitions below this size are insertion sorted
+constexpr std::ptrdiff_t INSERTION_SORT_THRESHOLD = 24;
+// Partitions above this size use the pseudomedian of 9 as pivot
+constexpr std::ptrdiff_t NINTHER_THRESHOLD = 128;
+// Element moves after which a partial insertion sort gives up
+constexpr std::ptrdiff_t PARTIAL_INSERTION_SORT_LIMIT = 8;
+// Elements classified per block by the branch-free partition, offsets fit in
+// a byte
+constexpr std::size_t BLOCK_SIZE = 64;
+constexpr std::size_t CACHELINE_SIZE = 64;
+
+template <typename It> using value_type = std::iter_value_t<It>;
+
+template <typename It, typename Less>
+void insertion_sort(It begin, It end, Less &less) {
+  if (begin == end) {
+    return;
+  }
+  for (auto cur = begin + 1; cur != end; ++cur) {
+    auto sift = cur;
+    auto sift_1 = cur - 1;
+    // Elements already in place are not moved
+    if (less(*sift, *sift_1)) {
+      value_type<It> tmp = std::move(*sift);
+      do {
+        *sift-- = std::move(*sift_1);
+      } while (sift != begin && less(tmp, *--sift_1));
+      *sift = std::move(tmp);
+    }
+  }
+}
+
+// Insertion sort without the bounds check, `*(begin - 1)` must not be greater
+// than any element of [begin, end)
+template <typename It, typename Less>
+void unguarded_insertion_sort(It begin, It end, Less &less) {
+  if (begin == end) {
+    return;
+  }
+  for (auto cur = begin + 1; cur != end; ++cur) {
+    auto sift = cur;
+    auto sift_1 = cur - 1;
+    if (less(*sift, *sift_1)) {
+      value_type<It> tmp = std::move(*sift);
+      do {
+        *sift-- = std::move(*sift_1);
+      } while (less(tmp, *--sift_1));
+      *sift = std::move(tmp);
+    }
+  }
+}
+
+// Insertion sort that gives up after PARTIAL_INSERTION_SORT_LIMIT moves,
+// returns whether the range is sorted
+template <typename It, typename Less>
+bool partial_insertion_sort(It begin, It end, Less &less) {
+  if (begin == end) {
+    return true;
+  }
+  std::ptrdiff_t moves = 0;
+  for (auto cur = begin + 1; cur != end; ++cur) {
+    auto sift = cur;
+    auto sift_1 = cur - 1;
+    if (less(*sift, *sift_1)) {
+      value_type<It> tmp = std::move(*sift);
+      do {
+        *sift-- = std::move(*sift_1);
+      } while (sift != begin && less(tmp, *--sift_1));
+      *sift = std::move(tmp);
+      moves += cur - sift;
+    }
+    if (moves > PARTIAL_INSERTION_SORT_LIMIT) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename It, typename Less> void sort2(It a, It b, Less &less) {
+  if (less(*b, *a)) {
+    std::iter_swap(a, b);
+  }
+}
+
+template <typename It, typename Less>
+void sort3(It a, It b, It c, Less &less) {
+  sort2(a, b, less);
+  sort2(b, c, less);
+  sort2(a, b, less);
+}
+
+inline std::uint8_t *align_cacheline(std::uint8_t *pointer) {
+  const auto address = reinterpret_cast<std::uintptr_t>(pointer);
+  const auto aligned = (address + CACHELINE_SIZE - 1) & ~(CACHELINE_SIZE - 1);
+  return pointer + (aligned - address);
+}
+
+// Swaps the elements at `offsets_l` from `first` with the ones at `offsets_r`
+// back from `last`. A cyclic permutation needs fewer moves, but swaps are
+// required when the blocks are the same size to stay linear on descending
+// input.
+template <typename It>
+void swap_offsets(
+    It first,
+    It last,
+    const std::uint8_t *offsets_l,
+    const std::uint8_t *offsets_r,
+    std::size_t count,
+    bool use_swaps
+) {
+  if (use_swaps) {
+    for (std::size_t i = 0; i < count; ++i) {
+      std::iter_swap(first + offsets_l[i], last - offsets_r[i]);
+    }
+  } else if (count > 0) {
+    auto left = first + offsets_l[0];
+    auto right = last - offsets_r[0];
+    value_type<It> tmp = std::move(*left);
+    *left = std::move(*right);
+    for (std::size_t i = 1; i < count; ++i) {
+      left = first + offsets_l[i];
+      *right = std::move(*left);
+      right = last - offsets_r[i];
+      *left = std::move(*right);
+    }
+    *right = std::move(tmp);
+  }
+}
+
+// Partitions [begin, end) around the pivot `*begin`, elements equal to it go
+// to the right. Returns the final pivot position and whether the range was
+// already partitioned.
+//
+// Elements are classified in blocks: the comparison results are accumulated
+// into offset buffers without branching, then the misplaced elements are
+// swapped in bulk (Edelkamp and Weiss, "BlockQuicksort"). Only worth it for
+// cheap comparisons.
+template <typename It, typename Less>
+std::pair<It, bool> partition_right_branchless(It begin, It end, Less &less) {
+  value_type<It> pivot = std::move(*begin);
+  auto first = begin;
+  auto last = end;
+
+  // The median of 3 guarantees that an element not less than the pivot exists
+  while (less(*++first, pivot)) {
+  }
+  // Guarded only if no element precedes `first`
+  if (first - 1 == begin) {
+    while (first < last && !less(*--last, pivot)) {
+    }
+  } else {
+    while (!less(*--last, pivot)) {
+    }
+  }
+
+  const bool already_partitioned = first >= last;
+  if (!already_partitioned) {
+    std::iter_swap(first, last);
+    ++first;
+
+    std::array<std::uint8_t, BLOCK_SIZE + CACHELINE_SIZE> offsets_l_storage;
+    std::array<std::uint8_t, BLOCK_SIZE + CACHELINE_SIZE> offsets_r_storage;
+    auto *offsets_l = align_cacheline(offsets_l_storage.data());
+    auto *offsets_r = align_cacheline(offsets_r_storage.data());
+
+    auto offsets_l_base = first;
+    auto offsets_r_base = last;
+    std::size_t count_l = 0;
+    std::size_t count_r = 0;
+    std::size_t start_l = 0;
+    std::size_t start_r = 0;
+
+    while (first < last) {
+      // Splits the unknown elements between the empty offset blocks
+      const auto unknown = static_cast<std::size_t>(last - first);
+      const std::size_t left_split =
+          count_l == 0 ? (count_r == 0 ? unknown / 2 : unknown) : 0;
+      const std::size_t right_split = count_r == 0 ? unknown - left_split : 0;
+
+      const auto block_l = std::min(left_split, BLOCK_SIZE);
+      for (std::size_t i = 0; i < block_l; ++i) {
+        offsets_l[count_l] = static_cast<std::uint8_t>(i);
+        count_l += static_cast<std::size_t>(!less(*first, pivot));
+        ++first;
+      }
+      const auto block_r = std::min(right_split, BLOCK_SIZE);
+      for (std::size_t i = 0; i < block_r; ++i) {
+        offsets_r[count_r] = static_cast<std::uint8_t>(i + 1);
+        count_r += static_cast<std::size_t>(less(*--last, pivot));
+      }
+
+      const auto count = std::min(count_l, count_r);
+      swap_offsets(
+          offsets_l_base,
+          offsets_r_base,
+          offsets_l + start_l,
+          offsets_r + start_r,
+          count,
+          count_l == count_r
+      );
+      count_l -= count;
+      count_r -= count;
+      start_l += count;
+      start_r += count;
+
+      if (count_l == 0) {
+        start_l = 0;
+        offsets_l_base = first;
+      }
+      if (count_r == 0) {
+        start_r = 0;
+        offsets_r_base = last;
+      }
+    }
+
+    // At most one block has misplaced elements left, they are swapped to the
+    // boundary between the partitions
+    if (count_l != 0) {
+      offsets_l += start_l;
+      while (count_l-- != 0) {
+        std::iter_swap(offsets_l_base + offsets_l[count_l], --last);
+      }
+      first = last;
+    }
+    if (count_r != 0) {
+      offsets_r += start_r;
+      while (count_r-- != 0) {
+        std::iter_swap(offsets_r_base - offsets_r[count_r], first);
+        ++first;
+      }
+      last = first;
+    }
+  }
+
+  const auto pivot_position = first - 1;
+  *begin = std::move(*pivot_position);
+  *pivot_position = std::move(pivot);
+  return {pivot_position, already_partitioned};
+}
+
+// Same as partition_right_branchless, with the classic Hoare loop
+template <typename It, typename Less>
+std::pair<It, bool> partition_right(It begin, It end, Less &less) {
+  value_type<It> pivot = std::move(*begin);
+  auto first = begin;
+  auto last = end;
+
+  while (less(*++first, pivot)) {
+  }
+  if (first - 1 == begin) {
+    while (first < last && !less(*--last, pivot)) {
+    }
+  } else {
+    while (!less(*--last, pivot)) {
+    }
+  }
+
+  const bool already_partitioned = first >= last;
+  while (first < last) {
+    std::iter_swap(first, last);
+    while (less(*++first, pivot)) {
+    }
+    while (!less(*--last, pivot)) {
+    }
+  }
+
+  const auto pivot_position = first - 1;
+  *begin = std::move(*pivot_position);
+  *pivot_position = std::move(pivot);
+  return {pivot_position, already_partitioned};
+}
+
+// Partitions [begin, end) around the pivot `*begin`, elements equal to it go
+// to the left. Used when the pivot equals the pivot of the parent partition,
+// the left side then holds only equal elements and needs no sorting.
+template <typename It, typename Less>
+It partition_left(It begin, It end, Less &less) {
+  value_type<It> pivot = std::move(*begin);
+  auto first = begin;
+  auto last = end;
+
+  while (less(pivot, *--last)) {
+  }
+  if (last + 1 == end) {
+    while (first < last && !less(pivot, *++first)) {
+    }
+  } else {
+    while (!less(pivot, *++first)) {
+    }
+  }
+
+  while (first < last) {
+    std::iter_swap(first, last);
+    while (less(pivot, *--last)) {
+    }
+    while (!less(pivot, *++first)) {
+    }
+  }
+
+  const auto pivot_position = last;
+  *begin = std::move(*pivot_position);
+  *pivot_position = std::move(pivot);
+  return pivot_position;
+}
+
+// Sorts [begin, end), recursing on the left partitions and looping on the right
+// ones. `bad_allowed` counts the unbalanced partitions left before heapsort,
+// `leftmost` is false when `*(begin - 1)` bounds the range from below.
+template <bool Branchless, typename It, typename Less>
+void sort_loop(It begin, It end, Less &less, int bad_allowed, bool leftmost) {
+  while (true) {
+    const auto size = end - begin;
+    if (size < INSERTION_SORT_THRESHOLD) {
+      if (leftmost) {
+        insertion_sort(begin, end, less);
+      } else {
+        unguarded_insertion_sort(begin, end, less);
+      }
+      return;
+    }
+
+    // Moves the pivot to `*begin`
+    const auto half = size / 2;
+    if (size > NINTHER_THRESHOLD) {
+      sort3(begin, begin + half, end - 1, less);
+      sort3(begin + 1, begin + (half - 1), end - 2, less);
+      sort3(begin + 2, begin + (half + 1), end - 3, less);
+      sort3(begin + (half - 1), begin + half, begin + (half + 1), less);
+      std::iter_swap(begin, begin + half);
+    } else {
+      sort3(begin + half, begin, end - 1, less);
+    }
+
+    // No element of the range is less than `*(begin - 1)`. A pivot equal to
+    // it starts a run of equal elements, which are grouped on the left and
+    // never sorted again.
+    if (!leftmost && !less(*(begin - 1), *begin)) {
+      begin = partition_left(begin, end, less) + 1;
+      continue;
+    }
+
+    const auto [pivot_position, already_partitioned] =
+        Branchless ? partition_right_branchless(begin, end, less)
+                   : partition_right(begin, end, less);
+
+    const auto l_size = pivot_position - begin;
+    const auto r_size = end - (pivot_position + 1);
+    const bool unbalanced = l_size < size / 8 || r_size < size / 8;
+
+    if (unbalanced) {
+      if (--bad_allowed == 0) {
+        std::make_heap(begin, end, less);
+        std::sort_heap(begin, end, less);
+        return;
+      }
+
+      // Shuffles a few elements to break the pattern behind the bad pivot
+      if (l_size >= INSERTION_SORT_THRESHOLD) {
+        std::iter_swap(begin, begin + (l_size / 4));
+        std::iter_swap(pivot_position - 1, pivot_position - (l_size / 4));
+        if (l_size > NINTHER_THRESHOLD) {
+          std::iter_swap(begin + 1, begin + ((l_size / 4) + 1));
+          std::iter_swap(begin + 2, begin + ((l_size / 4) + 2));
+          std::iter_swap(
+              pivot_position - 2, pivot_position - ((l_size / 4) + 1)
+          );
+          std::iter_swap(
+              pivot_position - 3, pivot_position - ((l_size / 4) + 2)
+          );
+        }
+      }
+      if (r_size >= INSERTION_SORT_THRESHOLD) {
+        std::iter_swap(
+            pivot_position + 1, pivot_position + (1 + (r_size / 4))
+        );
+        std::iter_swap(end - 1, end - (r_size / 4));
+        if (r_size > NINTHER_THRESHOLD) {
+          std::iter_swap(
+              pivot_position + 2, pivot_position + (2 + (r_size / 4))
+          );
+          std::iter_swap(
+              pivot_position + 3, pivot_position + (3 + (r_size / 4))
+          );
+          std::iter_swap(end - 2, end - (1 + (r_size / 4)));
+          std::iter_swap(end - 3, end - (2 + (r_size / 4)));
+        }
+      }
+    } else if (already_partitioned &&
+               partial_insertion_sort(begin, pivot_position, less) &&
+               partial_insertion_sort(pivot_position + 1, end, less)) {
+      // A partition that moved nothing hints at sorted input
+      return;
+    }
+
+    sort_loop<Branchless>(begin, pivot_position, less, bad_allowed, leftmost);
+    begin = pivot_position + 1;
+    leftmost = false;
+  }
+}
+
+} // namespace utils::pdq
+
+export namespace utils {
+
+// Sorts [begin, end) with pattern-defeating quicksort. Not stable. `less` must
+// be a strict weak order, it may throw, leaving the range in an unspecified
+// order.
+//
+// `Branchless` selects the block partition, which avoids mispredicted
+// branches when comparing is cheap, as for numbers. Expensive comparisons,
+// such as those of strings, are faster with the classic partition.
+template <
+    bool Branchless = false,
+    std::random_access_iterator It,
+    typename Less>
+void pdqsort(It begin, It end, Less less) {
+  if (begin == end) {
+    return;
+  }
+  const auto size = static_cast<std::size_t>(end - begin);
+  pdq::sort_loop<Branchless>(
+      begin, end, less, static_cast<int>(std::bit_width(size) - 1), true
+  );
+}
+
+template <
+    bool Branchless = false,
+    std::ranges::random_access_range R,
+    typename Less>
+void pdqsort(R &&range, Less less) {
+  pdqsort<Branchless>(
+      std::ranges::begin(range), std::ranges::end(range), less
+  );
+}
+
+} // namespace utils
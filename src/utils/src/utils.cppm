@@ -5,4 +5,5 @@ export import :format;
 export import :functional;
 export import :match;
 export import :ranges;
+export import :sort;
 export import :types;
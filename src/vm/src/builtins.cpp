@@ -8,9 +8,14 @@ import l3.runtime;
 namespace l3::builtins {
 
 namespace {
+using l3::runtime::Dict;
+using l3::runtime::Grid;
 using l3::runtime::HeapData;
+using l3::runtime::Iterator;
+using l3::runtime::PackedArray;
 using l3::runtime::Primitive;
 using l3::runtime::RuntimeError;
+using l3::runtime::Set;
 using l3::runtime::StackValue;
 using l3::runtime::TypeError;
 using l3::runtime::ValueError;
@@ -27,6 +32,212 @@ void format_args(
   }
 }
 
+// Returns the iterator held by `value`, iterators are advanced in place
+Iterator *as_iterator(StackValue value) {
+  auto *cell = value.get_heap_ptr();
+  if (cell == nullptr) {
+    return nullptr;
+  }
+  return std::get_if<Iterator>(&cell->get_value().get_inner());
+}
+
+// Returns the set held by `value`, sets are modified in place
+Set *as_mut_set(StackValue value) {
+  auto *cell = value.get_heap_ptr();
+  if (cell == nullptr) {
+    return nullptr;
+  }
+  return std::get_if<Set>(&cell->get_value().get_inner());
+}
+
+// Wraps vectors, ranges, packed arrays, grid rows, sets and strings in an
+// iterator, iterators are returned as they are
+StackValue make_iterator(
+    l3::vm::BytecodeVM &vm, const StackValue &value, std::string_view name
+) {
+  if (as_iterator(value) != nullptr) {
+    return value;
+  }
+  if (!value.is_vector() && !value.as_range() && !value.as_packed() &&
+      !value.as_grid_row() && !value.as_set() && !value.is_string()) {
+    throw TypeError(
+        "{}() cannot iterate over a {} value", name, value.type_name()
+    );
+  }
+  return vm.heap_store(Iterator{Iterator::Sequence{.source = value}});
+}
+
+// Pulls the next element of `iterator`, calling the functions of adapters
+std::optional<StackValue> next(l3::vm::BytecodeVM &vm, Iterator &iterator);
+
+std::optional<StackValue> next(l3::vm::BytecodeVM &vm, StackValue iterator) {
+  return next(vm, *as_iterator(iterator));
+}
+
+std::optional<StackValue> next(l3::vm::BytecodeVM &vm, Iterator &iterator) {
+  using Result = std::optional<StackValue>;
+  return iterator.visit(
+      [&](Iterator::Sequence &sequence) -> Result {
+        const auto index = sequence.position;
+        if (const auto vector_opt = sequence.source.as_vector()) {
+          if (index >= vector_opt->get().size()) {
+            return std::nullopt;
+          }
+          ++sequence.position;
+          return vector_opt->get()[index];
+        }
+        if (const auto range_opt = sequence.source.as_range()) {
+          if (index >= range_opt->get().size()) {
+            return std::nullopt;
+          }
+          ++sequence.position;
+          return range_opt->get()[index];
+        }
+        if (const auto packed_opt = sequence.source.as_packed()) {
+          if (index >= packed_opt->get().size()) {
+            return std::nullopt;
+          }
+          ++sequence.position;
+          return packed_opt->get()[index];
+        }
+        if (const auto row_opt = sequence.source.as_grid_row()) {
+          if (index >= row_opt->get().size()) {
+            return std::nullopt;
+          }
+          ++sequence.position;
+          return row_opt->get()[index];
+        }
+        if (const auto set_opt = sequence.source.as_set()) {
+          if (index >= set_opt->get().size()) {
+            return std::nullopt;
+          }
+          ++sequence.position;
+          return set_opt->get()[index];
+        }
+        const auto string = *sequence.source.as_string();
+        if (index >= string.size()) {
+          return std::nullopt;
+        }
+        ++sequence.position;
+        return vm.character(string[index]);
+      },
+      [&](Iterator::Map &map) -> Result {
+        return next(vm, map.inner).transform([&](const StackValue &item) {
+          return vm.call_function(map.function, std::array{item});
+        });
+      },
+      [&](Iterator::Filter &filter) -> Result {
+        while (auto item = next(vm, filter.inner)) {
+          if (vm.call_function(filter.function, std::array{*item})
+                  .is_truthy()) {
+            return item;
+          }
+        }
+        return std::nullopt;
+      },
+      [&](Iterator::TakeWhile &take_while) -> Result {
+        if (take_while.done) {
+          return std::nullopt;
+        }
+        auto item = next(vm, take_while.inner);
+        if (!item || !vm.call_function(take_while.function, std::array{*item})
+                          .is_truthy()) {
+          take_while.done = true;
+          return std::nullopt;
+        }
+        return item;
+      },
+      [&](Iterator::Zip &zip) -> Result {
+        auto left = next(vm, zip.left);
+        if (!left) {
+          return std::nullopt;
+        }
+        // The left element waits for the functions of the right side
+        std::vector pair{*left};
+        const l3::vm::BytecodeVM::RootGuard guard{vm, pair};
+        auto right = next(vm, zip.right);
+        if (!right) {
+          return std::nullopt;
+        }
+        pair.push_back(*right);
+        return vm.heap_store(std::move(pair));
+      },
+      [&](Iterator::Enumerate &enumerate) -> Result {
+        return next(vm, enumerate.inner).transform([&](const StackValue &item) {
+          return vm.heap_store(
+              std::vector{StackValue{Primitive{enumerate.index++}}, item}
+          );
+        });
+      }
+  );
+}
+
+// Input range over the remaining elements of an iterator, consuming them
+class IteratorItems {
+  l3::vm::BytecodeVM *vm;
+  Iterator *source;
+
+public:
+  class iterator {
+    const IteratorItems *items = nullptr;
+    std::optional<StackValue> current;
+
+  public:
+    using iterator_concept = std::input_iterator_tag;
+    using value_type = StackValue;
+    using difference_type = std::ptrdiff_t;
+
+    iterator() = default;
+    explicit iterator(const IteratorItems &items)
+        : items{&items}, current{next(*items.vm, *items.source)} {}
+
+    const StackValue &operator*() const { return *current; }
+    iterator &operator++() {
+      current = next(*items->vm, *items->source);
+      return *this;
+    }
+    void operator++(int) { ++*this; }
+    bool operator==(std::default_sentinel_t /*unused*/) const {
+      return !current;
+    }
+  };
+
+  IteratorItems(l3::vm::BytecodeVM &vm, Iterator &source)
+      : vm{&vm}, source{&source} {}
+
+  [[nodiscard]] iterator begin() const { return iterator{*this}; }
+  [[nodiscard]] std::default_sentinel_t end() const { return {}; }
+};
+
+// Calls `fn` with the elements of a vector, grid row or set, of a range or
+// packed array without materializing it, or of an iterator while consuming it
+StackValue with_items(
+    l3::vm::BytecodeVM &vm,
+    const StackValue &value,
+    std::string_view error,
+    const auto &fn
+) {
+  if (const auto vector_opt = value.as_vector()) {
+    return fn(vector_opt->get());
+  }
+  if (const auto range_opt = value.as_range()) {
+    return fn(range_opt->get().items());
+  }
+  if (const auto packed_opt = value.as_packed()) {
+    return fn(packed_opt->get().items());
+  }
+  if (const auto row_opt = value.as_grid_row()) {
+    return fn(row_opt->get().view());
+  }
+  if (const auto set_opt = value.as_set()) {
+    return fn(set_opt->get().items());
+  }
+  if (auto *iterator = as_iterator(value)) {
+    return fn(IteratorItems{vm, *iterator});
+  }
+  throw TypeError("{}", error);
+}
+
 StackValue
 builtin_print(l3::vm::BytecodeVM & /*vm*/, l3::runtime::L3Args args) {
   format_args(std::ostream_iterator<char>(std::cout), args);
@@ -48,6 +259,38 @@ builtin_trigger_gc(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
   return {};
 }
 
+// Returns [collections, roots_ns, mark_ns, sweep_ns, max_pause_ns,
+// cells_freed, bytes_freed, upvalues_freed, cells_surviving,
+// upvalues_surviving, heap_chunks, upvalue_chunks]
+StackValue builtin_gc_stats(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
+  if (!args.empty()) {
+    throw RuntimeError("gc_stats() takes no arguments");
+  }
+  const auto &stats = vm.get_gc_stats();
+  const auto count = [](std::size_t value) {
+    return StackValue{Primitive{static_cast<std::int64_t>(value)}};
+  };
+  const auto nanos = [](l3::runtime::GcStats::duration value) {
+    return StackValue{Primitive{static_cast<std::int64_t>(value.count())}};
+  };
+  return vm.heap_store(
+      std::vector{
+          count(stats.collections),
+          nanos(stats.roots_time),
+          nanos(stats.mark_time),
+          nanos(stats.sweep_time),
+          nanos(stats.max_pause),
+          count(stats.cells_freed),
+          count(stats.bytes_freed),
+          count(stats.upvalues_freed),
+          count(stats.cells_surviving),
+          count(stats.upvalues_surviving),
+          count(stats.heap_chunks),
+          count(stats.upvalue_chunks),
+      }
+  );
+}
+
 StackValue
 builtin_assert(l3::vm::BytecodeVM & /*vm*/, l3::runtime::L3Args args) {
   if (args[0].is_truthy()) {
@@ -109,9 +352,10 @@ StackValue builtin_int(l3::vm::BytecodeVM & /*vm*/, l3::runtime::L3Args args) {
       return static_cast<std::int64_t>(value);
     });
   } else if (auto string_opt = arg.as_string()) {
-    const auto &string = string_opt->get();
-    auto result =
-        std::from_chars(&*string.begin(), &*string.end(), value, base);
+    const auto string = *string_opt;
+    auto result = std::from_chars(
+        string.data(), string.data() + string.size(), value, base
+    );
     if (result.ec != std::errc{}) {
       throw RuntimeError(
           "invalid integer literal '{}' in base {}", string, base
@@ -151,34 +395,70 @@ StackValue builtin_head_tail(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
 
     if constexpr (IsHead) {
       auto h = vec.front();
-      auto rest = std::vector<StackValue>(vec.begin() + 1, vec.end());
-      return vm.heap_store(std::vector{h, vm.heap_store(std::move(rest))});
+      auto rest = vm.heap_store(
+          argument.slice(l3::runtime::Slice{.start = 1, .end = std::nullopt})
+      );
+      return vm.heap_store(std::vector{h, rest});
     } else {
       auto t = vec.back();
-      auto rest = std::vector<StackValue>(vec.begin(), vec.end() - 1);
-      return vm.heap_store(std::vector{vm.heap_store(std::move(rest)), t});
+      auto rest = vm.heap_store(argument.slice(l3::runtime::Slice{
+          .start = std::nullopt, .end = std::ssize(vec) - 1
+      }));
+      return vm.heap_store(std::vector{rest, t});
     }
   }
 
   if (const auto &string_opt = argument.as_string()) {
-    const auto &string = string_opt->get();
+    const auto string = *string_opt;
 
     if (string.empty()) {
       throw RuntimeError("head/tail() takes a non-empty string");
     }
 
     if constexpr (IsHead) {
-      auto h = vm.heap_store(std::string{string.front()});
-      auto rest = vm.heap_store(std::string(string.substr(1)));
+      auto h = vm.character(string.front());
+      auto rest = vm.heap_store(
+          argument.slice(l3::runtime::Slice{.start = 1, .end = std::nullopt})
+      );
       return vm.heap_store(std::vector{h, rest});
     } else {
-      auto t = vm.heap_store(std::string{string.back()});
-      auto rest =
-          vm.heap_store(std::string(string.substr(0, string.size() - 1)));
+      auto t = vm.character(string.back());
+      auto rest = vm.heap_store(argument.slice(l3::runtime::Slice{
+          .start = std::nullopt, .end = std::ssize(string) - 1
+      }));
       return vm.heap_store(std::vector{rest, t});
     }
   }
 
+  // Ranges, packed arrays and grid rows index their elements directly
+  const auto head_tail_computed = [&](const auto &sequence) {
+    if (sequence.empty()) {
+      throw RuntimeError("head/tail() takes a non-empty vector");
+    }
+
+    if constexpr (IsHead) {
+      auto rest = vm.heap_store(
+          argument.slice(l3::runtime::Slice{.start = 1, .end = std::nullopt})
+      );
+      return vm.heap_store(std::vector{sequence[0], rest});
+    } else {
+      auto rest = vm.heap_store(argument.slice(l3::runtime::Slice{
+          .start = std::nullopt, .end = std::ssize(sequence) - 1
+      }));
+      return vm.heap_store(std::vector{rest, sequence[sequence.size() - 1]});
+    }
+  };
+
+  if (const auto &range_opt = argument.as_range()) {
+    return head_tail_computed(range_opt->get());
+  }
+  if (const auto &packed_opt = argument.as_packed()) {
+    return head_tail_computed(packed_opt->get());
+  }
+  if (const auto &row_opt = argument.as_grid_row()) {
+    return head_tail_computed(row_opt->get());
+  }
+
   throw TypeError("head/tail() takes only vector and string values");
 }
 
@@ -198,7 +478,7 @@ StackValue builtin_len(l3::vm::BytecodeVM & /*vm*/, l3::runtime::L3Args args) {
   const auto &arg = args[0];
   if (arg.is_string()) {
     return {
-        Primitive{static_cast<std::int64_t>(arg.as_string()->get().size())}
+        Primitive{static_cast<std::int64_t>(arg.as_string()->size())}
     };
   }
   if (arg.is_vector()) {
@@ -206,6 +486,25 @@ StackValue builtin_len(l3::vm::BytecodeVM & /*vm*/, l3::runtime::L3Args args) {
         Primitive{static_cast<std::int64_t>(arg.as_vector()->get().size())}
     };
   }
+  if (const auto range_opt = arg.as_range()) {
+    return {Primitive{static_cast<std::int64_t>(range_opt->get().size())}};
+  }
+  if (const auto packed_opt = arg.as_packed()) {
+    return {Primitive{static_cast<std::int64_t>(packed_opt->get().size())}};
+  }
+  if (const auto row_opt = arg.as_grid_row()) {
+    return {Primitive{static_cast<std::int64_t>(row_opt->get().size())}};
+  }
+  // Grids are indexed, and iterated, by row
+  if (const auto grid_opt = arg.as_grid()) {
+    return {Primitive{static_cast<std::int64_t>(grid_opt->get().rows())}};
+  }
+  if (const auto dict_opt = arg.as_dict()) {
+    return {Primitive{static_cast<std::int64_t>(dict_opt->get().size())}};
+  }
+  if (const auto set_opt = arg.as_set()) {
+    return {Primitive{static_cast<std::int64_t>(set_opt->get().size())}};
+  }
   throw TypeError("len() does not support {} values");
 }
 
@@ -259,10 +558,7 @@ StackValue builtin_slice(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
 }
 
 StackValue
-builtin_random(l3::vm::BytecodeVM & /*vm*/, l3::runtime::L3Args args) {
-  static std::random_device rd;
-  static std::mt19937 gen(rd());
-
+builtin_random(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
   if (args.empty() || args.size() > 2) {
     throw RuntimeError("random() takes one or two arguments");
   }
@@ -287,7 +583,7 @@ builtin_random(l3::vm::BytecodeVM & /*vm*/, l3::runtime::L3Args args) {
 
   auto distribution = std::uniform_int_distribution<std::int64_t>{min, max};
 
-  return {Primitive{distribution(gen)}};
+  return {Primitive{distribution(vm.random_engine())}};
 }
 
 StackValue
@@ -313,21 +609,20 @@ StackValue builtin_map(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
     throw TypeError("map() first argument must be a function");
   }
 
-  const auto list_opt = args[1].as_vector();
-  if (!list_opt) {
-    throw TypeError("map() second argument must be a vector");
-  }
-  const auto &list = list_opt->get();
-
-  auto result = std::views::transform(
-                    list,
-                    [&](const auto &item) {
-                      return vm.call_function(args[0], std::array{item});
-                    }
-                ) |
-                std::ranges::to<std::vector>();
-
-  return vm.heap_store(std::move(result));
+  return with_items(
+      vm,
+      args[1],
+      "map() second argument must be a vector",
+      [&](const auto &list) {
+        std::vector<StackValue> result;
+        const l3::vm::BytecodeVM::RootGuard guard{vm, result};
+        for (const auto &item : list) {
+          result.push_back(vm.call_function(args[0], std::array{item}));
+        }
+
+        return vm.heap_store(std::move(result));
+      }
+  );
 }
 
 StackValue builtin_filter(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
@@ -339,71 +634,211 @@ StackValue builtin_filter(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
     throw TypeError("filter() first argument must be a function");
   }
 
-  const auto list_opt = args[1].as_vector();
-  if (!list_opt) {
-    throw TypeError("filter() second argument must be a vector");
+  return with_items(
+      vm,
+      args[1],
+      "filter() second argument must be a vector",
+      [&](const auto &list) {
+        // Elements of an iterator are only held here, and the function may
+        // remove elements from the vector it is given
+        auto result = std::vector<StackValue>{};
+        const l3::vm::BytecodeVM::RootGuard guard{vm, result};
+        for (const auto &item : list) {
+          if (vm.call_function(args[0], std::array{item}).is_truthy()) {
+            result.push_back(item);
+          }
+        }
+
+        // Filtering a set keeps a set
+        if (args[1].as_set()) {
+          return vm.heap_store(Set{result});
+        }
+        return vm.heap_store(std::move(result));
+      }
+  );
+}
+
+// map() with the calls spread over worker VMs on other threads. A function
+// sharing a `mut` variable with this VM runs here instead, its copy in a
+// worker would not update the variable.
+StackValue builtin_pmap(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
+  if (args.size() != 2) {
+    throw TypeError("pmap() takes exactly 2 arguments");
   }
-  const auto &list = list_opt->get();
 
-  auto result = std::vector<StackValue>{};
-  for (const auto &item : list) {
-    if (vm.call_function(args[0], std::array{item}).is_truthy()) {
-      result.push_back(item);
-    }
+  if (!args[0].is_function()) {
+    throw TypeError("pmap() first argument must be a function");
   }
 
-  return vm.heap_store(std::move(result));
+  if (l3::vm::BytecodeVM::captures_mutable(args[0])) {
+    return builtin_map(vm, args);
+  }
+
+  return with_items(
+      vm,
+      args[1],
+      "pmap() second argument must be a vector",
+      [&](const auto &list) {
+        // Elements read from an iterator are only held here while the
+        // functions of its adapters run
+        std::vector<StackValue> items;
+        const l3::vm::BytecodeVM::RootGuard guard{vm, items};
+        std::ranges::copy(list, std::back_inserter(items));
+        return vm.heap_store(vm.parallel_map(args[0], items));
+      }
+  );
 }
 
-StackValue builtin_sum(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
+// filter() with the predicate run like the function of pmap()
+StackValue builtin_pfilter(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
+  if (args.size() != 2) {
+    throw TypeError("pfilter() takes exactly 2 arguments");
+  }
+
+  if (!args[0].is_function()) {
+    throw TypeError("pfilter() first argument must be a function");
+  }
+
+  if (l3::vm::BytecodeVM::captures_mutable(args[0])) {
+    return builtin_filter(vm, args);
+  }
+
+  return with_items(
+      vm,
+      args[1],
+      "pfilter() second argument must be a vector",
+      [&](const auto &list) {
+        // Elements read from an iterator are only held here while the
+        // functions of its adapters run
+        std::vector<StackValue> items;
+        const l3::vm::BytecodeVM::RootGuard guard{vm, items};
+        std::ranges::copy(list, std::back_inserter(items));
+        const auto keep = vm.parallel_map(args[0], items);
+        auto result =
+            std::views::zip(items, keep) |
+            std::views::filter([](const auto &pair) {
+              return std::get<1>(pair).is_truthy();
+            }) |
+            std::views::transform([](const auto &pair) {
+              return std::get<0>(pair);
+            }) |
+            std::ranges::to<std::vector>();
+
+        if (args[1].as_set()) {
+          return vm.heap_store(Set{result});
+        }
+        return vm.heap_store(std::move(result));
+      }
+  );
+}
+
+// Runs the function with the rest of the arguments as a task, see
+// BytecodeVM::spawn()
+StackValue builtin_spawn(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
+  if (args.empty()) {
+    throw TypeError("spawn() takes at least one argument");
+  }
+
+  if (!args[0].is_function()) {
+    throw TypeError("spawn() first argument must be a function");
+  }
+
+  return vm.spawn(args[0], args.subspan(1));
+}
+
+StackValue builtin_await(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
   if (args.size() != 1) {
-    throw TypeError("sum() takes exactly 1 argument");
+    throw TypeError("await() takes exactly 1 argument");
   }
 
-  const auto list_opt = args[0].as_vector();
-  if (!list_opt) {
-    throw TypeError("sum() argument must be a vector");
+  const auto future = args[0].as_future();
+  if (!future) {
+    throw TypeError("await() argument must be a future");
   }
-  const auto &list = list_opt->get();
 
-  if (list.empty()) {
-    throw TypeError("sum() cannot be applied to an empty vector");
+  return vm.await(*future);
+}
+
+StackValue builtin_sum(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
+  if (args.size() != 1) {
+    throw TypeError("sum() takes exactly 1 argument");
+  }
+
+  if (const auto range_opt = args[0].as_range()) {
+    const auto &range = range_opt->get();
+    if (range.empty()) {
+      throw TypeError("sum() cannot be applied to an empty vector");
+    }
+    if (const auto total = range.sum()) {
+      return {Primitive{*total}};
+    }
+    return vm.heap_store(range.big_sum());
   }
 
-  HeapData total = l3::runtime::to_owned(list.front());
-  for (const auto &item : list | std::views::drop(1)) {
-    total.add_assign(l3::runtime::to_owned(item));
+  if (const auto packed_opt = args[0].as_packed()) {
+    const auto &packed = packed_opt->get();
+    if (packed.empty()) {
+      throw TypeError("sum() cannot be applied to an empty vector");
+    }
+    if (const auto total = packed.sum()) {
+      return {*total};
+    }
   }
 
-  return vm.heap_store(std::move(total));
+  return with_items(
+      vm,
+      args[0],
+      "sum() argument must be a vector",
+      [&](const auto &list) {
+        std::optional<HeapData> total;
+        for (const auto &item : list) {
+          if (total) {
+            total->add_assign(l3::runtime::to_owned(item));
+          } else {
+            total = l3::runtime::to_owned(item);
+          }
+        }
+
+        if (!total) {
+          throw TypeError("sum() cannot be applied to an empty vector");
+        }
+        return vm.heap_store(std::move(*total));
+      }
+  );
 }
 
 template <bool IsAll>
 StackValue
-builtin_all_any(l3::vm::BytecodeVM & /*vm*/, l3::runtime::L3Args args) {
+builtin_all_any(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
   if (args.size() != 1) {
     throw TypeError("all/any() takes exactly 1 argument");
   }
 
-  const auto list_opt = args[0].as_vector();
-  if (!list_opt) {
-    throw TypeError("all/any() argument must be a vector");
+  if (const auto packed_opt = args[0].as_packed()) {
+    const auto &packed = packed_opt->get();
+    return {Primitive{IsAll ? packed.all() : packed.any()}};
   }
-  const auto &list = list_opt->get();
 
-  for (const auto &item : list) {
-    if constexpr (IsAll) {
-      if (!item.is_truthy()) {
-        return StackValue{Primitive{false}};
-      }
-    } else {
-      if (item.is_truthy()) {
-        return StackValue{Primitive{true}};
+  return with_items(
+      vm,
+      args[0],
+      "all/any() argument must be a vector",
+      [](const auto &list) {
+        for (const auto &item : list) {
+          if constexpr (IsAll) {
+            if (!item.is_truthy()) {
+              return StackValue{Primitive{false}};
+            }
+          } else {
+            if (item.is_truthy()) {
+              return StackValue{Primitive{true}};
+            }
+          }
+        }
+
+        return StackValue{Primitive{IsAll}};
       }
-    }
-  }
-
-  return StackValue{Primitive{IsAll}};
+  );
 }
 
 StackValue builtin_all(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
@@ -415,28 +850,691 @@ StackValue builtin_any(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
 }
 
 StackValue builtin_count(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
+  // Without a predicate, counts the truthy elements
+  if (args.size() == 1) {
+    if (const auto packed_opt = args[0].as_packed()) {
+      return {Primitive{static_cast<std::int64_t>(packed_opt->get().count())}};
+    }
+    return with_items(
+        vm,
+        args[0],
+        "count() argument must be a vector",
+        [](const auto &list) {
+          std::int64_t count = 0;
+          for (const auto &item : list) {
+            if (item.is_truthy()) {
+              ++count;
+            }
+          }
+          return StackValue{Primitive{count}};
+        }
+    );
+  }
+
   if (args.size() != 2) {
-    throw TypeError("count() takes exactly 2 arguments");
+    throw TypeError("count() takes 1 or 2 arguments");
   }
 
   if (!args[0].is_function()) {
     throw TypeError("count() first argument must be a function");
   }
 
-  const auto list_opt = args[1].as_vector();
-  if (!list_opt) {
-    throw TypeError("count() second argument must be a vector");
+  return with_items(
+      vm,
+      args[1],
+      "count() second argument must be a vector",
+      [&](const auto &list) {
+        std::int64_t count = 0;
+        for (const auto &item : list) {
+          if (vm.call_function(args[0], std::array{item}).is_truthy()) {
+            ++count;
+          }
+        }
+
+        return StackValue{Primitive{count}};
+      }
+  );
+}
+
+StackValue builtin_reduce(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
+  if (args.size() != 2) {
+    throw TypeError("reduce() takes exactly 2 arguments");
+  }
+
+  if (!args[0].is_function()) {
+    throw TypeError("reduce() first argument must be a function");
+  }
+
+  return with_items(
+      vm,
+      args[1],
+      "reduce() second argument must be a vector",
+      [&](const auto &list) {
+        // Empty until the first element, rooted while iterator adapters run
+        std::vector<StackValue> accumulator;
+        const l3::vm::BytecodeVM::RootGuard guard{vm, accumulator};
+        for (const auto &item : list) {
+          if (accumulator.empty()) {
+            accumulator.push_back(item);
+          } else {
+            accumulator[0] =
+                vm.call_function(args[0], std::array{accumulator[0], item});
+          }
+        }
+
+        if (accumulator.empty()) {
+          throw TypeError("reduce() cannot be applied to an empty vector");
+        }
+        return accumulator[0];
+      }
+  );
+}
+
+StackValue builtin_fold(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
+  if (args.size() != 3) {
+    throw TypeError("fold() takes exactly 3 arguments");
+  }
+
+  if (!args[0].is_function()) {
+    throw TypeError("fold() first argument must be a function");
+  }
+
+  return with_items(
+      vm,
+      args[2],
+      "fold() third argument must be a vector",
+      [&](const auto &list) {
+        // Rooted while iterator adapters run
+        std::vector accumulator{args[1]};
+        const l3::vm::BytecodeVM::RootGuard guard{vm, accumulator};
+        for (const auto &item : list) {
+          accumulator[0] =
+              vm.call_function(args[0], std::array{accumulator[0], item});
+        }
+        return accumulator[0];
+      }
+  );
+}
+
+// Unboxed copies of `values` if they all hold a T
+template <typename T>
+std::optional<std::vector<T>> unbox(std::span<const StackValue> values) {
+  std::vector<T> unboxed;
+  unboxed.reserve(values.size());
+  for (const auto &value : values) {
+    if constexpr (std::same_as<T, std::string_view>) {
+      const auto string = value.as_string();
+      if (!string) {
+        return std::nullopt;
+      }
+      unboxed.push_back(*string);
+    } else {
+      const auto primitive = value.as_primitive();
+      const auto *element =
+          primitive ? std::get_if<T>(&primitive->get().get_inner()) : nullptr;
+      if (element == nullptr) {
+        return std::nullopt;
+      }
+      unboxed.push_back(*element);
+    }
+  }
+  return unboxed;
+}
+
+void check_not_nan(std::span<const double> values, std::string_view name) {
+  const auto is_nan = [](double value) { return std::isnan(value); };
+  if (std::ranges::any_of(values, is_nan)) {
+    throw ValueError("{}() cannot sort NaN", name);
+  }
+}
+
+// Positions of `keys` in ascending order, equal keys keep their order.
+// `order` is a three-way comparison of two keys.
+template <bool Branchless, typename Key>
+std::vector<std::uint32_t>
+order_by_keys(std::vector<Key> &&keys, const auto &order) {
+  struct Entry {
+    Key key;
+    std::uint32_t position;
+  };
+  auto entries =
+      std::views::zip(keys, std::views::iota(0U)) |
+      std::views::transform([](auto &&pair) {
+        return Entry{std::move(std::get<0>(pair)), std::get<1>(pair)};
+      }) |
+      std::ranges::to<std::vector>();
+
+  utils::pdqsort<Branchless>(entries, [&](const Entry &lhs, const Entry &rhs) {
+    const auto result = order(lhs.key, rhs.key);
+    return result < 0 || (result == 0 && lhs.position < rhs.position);
+  });
+  return entries | std::views::transform(&Entry::position) |
+         std::ranges::to<std::vector>();
+}
+
+// Positions of `keys` in ascending order. Keys that are all integers, all
+// doubles or all strings are sorted unboxed, numbers with the branch-free
+// partition; other keys are ordered with `runtime::compare`.
+std::vector<std::uint32_t>
+sorted_positions(std::span<const StackValue> keys, std::string_view name) {
+  if (keys.size() > std::numeric_limits<std::uint32_t>::max()) {
+    throw ValueError("{}() argument is too large", name);
+  }
+  if (auto ints = unbox<std::int64_t>(keys)) {
+    return order_by_keys<true>(std::move(*ints), std::compare_three_way{});
+  }
+  if (auto doubles = unbox<double>(keys)) {
+    check_not_nan(*doubles, name);
+    return order_by_keys<true>(
+        std::move(*doubles), std::compare_three_way{}
+    );
+  }
+  if (auto strings = unbox<std::string_view>(keys)) {
+    return order_by_keys<false>(
+        std::move(*strings), std::compare_three_way{}
+    );
+  }
+  return order_by_keys<false>(
+      std::vector<StackValue>(keys.begin(), keys.end()),
+      [name](const StackValue &lhs, const StackValue &rhs) {
+        const auto result = l3::runtime::compare(lhs, rhs);
+        if (result == std::partial_ordering::unordered) {
+          throw TypeError(
+              "{}() cannot order {} and {} values",
+              name,
+              lhs.type_name(),
+              rhs.type_name()
+          );
+        }
+        return result;
+      }
+  );
+}
+
+std::vector<StackValue> gather(
+    std::span<const StackValue> values, std::span<const std::uint32_t> order
+) {
+  return order |
+         std::views::transform([&](std::uint32_t position) {
+           return values[position];
+         }) |
+         std::ranges::to<std::vector>();
+}
+
+StackValue builtin_sort(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
+  if (args.size() != 1) {
+    throw TypeError("sort() takes exactly 1 argument");
+  }
+
+  if (const auto packed_opt = args[0].as_packed()) {
+    return vm.heap_store(packed_opt->get().sorted());
   }
-  const auto &list = list_opt->get();
 
-  std::int64_t count = 0;
-  for (const auto &item : list) {
-    if (vm.call_function(args[0], std::array{item}).is_truthy()) {
-      ++count;
+  return with_items(
+      vm, args[0], "sort() argument must be a vector", [&](const auto &list) {
+        std::vector<StackValue> values;
+        const l3::vm::BytecodeVM::RootGuard guard{vm, values};
+        std::ranges::copy(list, std::back_inserter(values));
+
+        // Numbers need no positions, they are sorted and boxed again
+        if (auto ints = unbox<std::int64_t>(values)) {
+          utils::pdqsort<true>(*ints, std::ranges::less{});
+          std::ranges::transform(
+              *ints, values.begin(), [](std::int64_t value) {
+                return StackValue{Primitive{value}};
+              }
+          );
+          return vm.heap_store(std::move(values));
+        }
+        if (auto doubles = unbox<double>(values)) {
+          check_not_nan(*doubles, "sort");
+          utils::pdqsort<true>(*doubles, std::ranges::less{});
+          std::ranges::transform(*doubles, values.begin(), [](double value) {
+            return StackValue{Primitive{value}};
+          });
+          return vm.heap_store(std::move(values));
+        }
+
+        return vm.heap_store(gather(values, sorted_positions(values, "sort")));
+      }
+  );
+}
+
+// Sorts by the keys `fn` returns for the elements, calling it once per
+// element. Elements with equal keys keep their order.
+StackValue builtin_sort_by(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
+  if (args.size() != 2) {
+    throw TypeError("sort_by() takes exactly 2 arguments");
+  }
+
+  if (!args[0].is_function()) {
+    throw TypeError("sort_by() first argument must be a function");
+  }
+
+  return with_items(
+      vm,
+      args[1],
+      "sort_by() second argument must be a vector",
+      [&](const auto &list) {
+        // Keys, and elements read from an iterator, are only held here while
+        // the next keys are computed
+        std::vector<StackValue> values;
+        const l3::vm::BytecodeVM::RootGuard values_guard{vm, values};
+        std::ranges::copy(list, std::back_inserter(values));
+        std::vector<StackValue> keys;
+        const l3::vm::BytecodeVM::RootGuard keys_guard{vm, keys};
+        keys.reserve(values.size());
+        for (const auto &value : values) {
+          keys.push_back(vm.call_function(args[0], std::array{value}));
+        }
+
+        return vm.heap_store(gather(values, sorted_positions(keys, "sort_by")));
+      }
+  );
+}
+
+StackValue builtin_iter(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
+  if (args.size() != 1) {
+    throw TypeError("iter() takes exactly 1 argument");
+  }
+  return make_iterator(vm, args[0], "iter");
+}
+
+template <typename Stage>
+StackValue make_adapter(
+    l3::vm::BytecodeVM &vm, l3::runtime::L3Args args, std::string_view name
+) {
+  if (args.size() != 2) {
+    throw TypeError("{}() takes exactly 2 arguments", name);
+  }
+
+  if (!args[0].is_function()) {
+    throw TypeError("{}() first argument must be a function", name);
+  }
+
+  auto inner = make_iterator(vm, args[1], name);
+  return vm.heap_store(Iterator{Stage{.function = args[0], .inner = inner}});
+}
+
+StackValue builtin_imap(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
+  return make_adapter<Iterator::Map>(vm, args, "imap");
+}
+
+StackValue builtin_ifilter(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
+  return make_adapter<Iterator::Filter>(vm, args, "ifilter");
+}
+
+StackValue
+builtin_take_while(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
+  return make_adapter<Iterator::TakeWhile>(vm, args, "take_while");
+}
+
+StackValue builtin_zip(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
+  if (args.size() != 2) {
+    throw TypeError("zip() takes exactly 2 arguments");
+  }
+
+  auto left = make_iterator(vm, args[0], "zip");
+  auto right = make_iterator(vm, args[1], "zip");
+  return vm.heap_store(Iterator{Iterator::Zip{.left = left, .right = right}});
+}
+
+StackValue
+builtin_enumerate(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
+  if (args.size() != 1) {
+    throw TypeError("enumerate() takes exactly 1 argument");
+  }
+
+  auto inner = make_iterator(vm, args[0], "enumerate");
+  return vm.heap_store(Iterator{Iterator::Enumerate{.inner = inner}});
+}
+
+StackValue
+builtin_collect(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
+  if (args.size() != 1) {
+    throw TypeError("collect() takes exactly 1 argument");
+  }
+
+  return with_items(
+      vm,
+      make_iterator(vm, args[0], "collect"),
+      "collect() argument must be iterable",
+      [&](const auto &list) {
+        // The functions of the adapters may collect while elements are read
+        std::vector<StackValue> values;
+        const l3::vm::BytecodeVM::RootGuard guard{vm, values};
+        std::ranges::copy(list, std::back_inserter(values));
+        return vm.heap_store(std::move(values));
+      }
+  );
+}
+
+StackValue builtin_array(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
+  if (args.size() != 1) {
+    throw TypeError("array() takes exactly 1 argument");
+  }
+
+  if (const auto packed_opt = args[0].as_packed()) {
+    return vm.heap_store(PackedArray{packed_opt->get()});
+  }
+
+  return with_items(
+      vm,
+      args[0],
+      "array() argument must be a vector",
+      [&](const auto &list) {
+        // Iterators are single pass, the first element is read only once
+        auto first = std::ranges::begin(list);
+        if (first == std::ranges::end(list)) {
+          return vm.heap_store(PackedArray{});
+        }
+        auto packed = PackedArray::pack(
+            std::ranges::subrange{std::move(first), std::ranges::end(list)}
+        );
+        if (!packed) {
+          throw TypeError(
+              "array() elements must be all ints, all doubles or all bools"
+          );
+        }
+        return vm.heap_store(std::move(*packed));
+      }
+  );
+}
+
+// Returns the packed elements of `value`, packing a vector or range into
+// `storage` first
+const PackedArray *as_packed_operand(
+    const StackValue &value, std::optional<PackedArray> &storage
+) {
+  if (const auto packed_opt = value.as_packed()) {
+    return &packed_opt->get();
+  }
+  if (const auto vector_opt = value.as_vector()) {
+    const auto &vector = vector_opt->get();
+    storage = vector.empty() ? PackedArray{} : PackedArray::pack(vector);
+  } else if (const auto range_opt = value.as_range()) {
+    storage = PackedArray::pack(range_opt->get().items());
+  }
+  return storage ? &*storage : nullptr;
+}
+
+// Int elements whose results overflow are computed again one by one, into a
+// vector holding BigInts. `rhs` returns the right operand of each element.
+// Comparisons never overflow, only the arithmetic operations get here.
+template <PackedArray::Operation Operation>
+StackValue boxed_elementwise(
+    l3::vm::BytecodeVM &vm, const PackedArray &lhs, const auto &rhs
+) {
+  constexpr auto operation =
+      Operation == PackedArray::Operation::Add        ? &l3::runtime::add
+      : Operation == PackedArray::Operation::Subtract ? &l3::runtime::sub
+                                                      : &l3::runtime::mul;
+  std::vector<StackValue> result;
+  result.reserve(lhs.size());
+  for (std::size_t i = 0; i < lhs.size(); ++i) {
+    result.push_back(vm.heap_store(operation(lhs[i], rhs(i))));
+  }
+  return vm.heap_store(std::move(result));
+}
+
+template <PackedArray::Operation Operation>
+StackValue builtin_elementwise(
+    l3::vm::BytecodeVM &vm, l3::runtime::L3Args args, std::string_view name
+) {
+  if (args.size() != 2) {
+    throw TypeError("{}() takes exactly 2 arguments", name);
+  }
+
+  std::optional<PackedArray> lhs_storage;
+  const auto *lhs = as_packed_operand(args[0], lhs_storage);
+  if (lhs == nullptr) {
+    throw TypeError(
+        "{}() first argument must be a vector of numbers or bools", name
+    );
+  }
+
+  if (const auto scalar_opt = args[1].as_primitive()) {
+    if (auto result =
+            PackedArray::elementwise(Operation, *lhs, scalar_opt->get())) {
+      return vm.heap_store(std::move(*result));
+    }
+    return boxed_elementwise<Operation>(vm, *lhs, [&](std::size_t) {
+      return args[1];
+    });
+  }
+
+  std::optional<PackedArray> rhs_storage;
+  const auto *rhs = as_packed_operand(args[1], rhs_storage);
+  if (rhs == nullptr) {
+    throw TypeError(
+        "{}() second argument must be a vector of numbers or bools, or a "
+        "number or bool",
+        name
+    );
+  }
+  if (auto result = PackedArray::elementwise(Operation, *lhs, *rhs)) {
+    return vm.heap_store(std::move(*result));
+  }
+  return boxed_elementwise<Operation>(vm, *lhs, [&](std::size_t i) {
+    return (*rhs)[i];
+  });
+}
+
+StackValue builtin_vadd(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
+  return builtin_elementwise<PackedArray::Operation::Add>(vm, args, "vadd");
+}
+
+StackValue builtin_vsub(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
+  return builtin_elementwise<PackedArray::Operation::Subtract>(
+      vm, args, "vsub"
+  );
+}
+
+StackValue builtin_vmul(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
+  return builtin_elementwise<PackedArray::Operation::Multiply>(
+      vm, args, "vmul"
+  );
+}
+
+StackValue builtin_veq(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
+  return builtin_elementwise<PackedArray::Operation::Equal>(vm, args, "veq");
+}
+
+StackValue builtin_grid(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
+  if (args.size() == 3) {
+    const auto height = args[0].as_primitive().and_then(&Primitive::as_integer);
+    const auto width = args[1].as_primitive().and_then(&Primitive::as_integer);
+    if (!height || !width) {
+      throw TypeError("grid() dimensions must be integers");
+    }
+    if (*height < 0 || *width < 0) {
+      throw ValueError("grid() dimensions cannot be negative");
     }
+    const auto rows = static_cast<std::size_t>(*height);
+    const auto columns = static_cast<std::size_t>(*width);
+    return vm.heap_store(
+        Grid{rows, columns, std::vector<StackValue>(rows * columns, args[2])}
+    );
+  }
+
+  if (args.size() != 1) {
+    throw TypeError("grid() takes 1 or 3 arguments");
+  }
+
+  std::vector<StackValue> cells;
+  std::size_t rows = 0;
+  std::optional<std::size_t> columns;
+  with_items(
+      vm,
+      args[0],
+      "grid() argument must be a vector of rows",
+      [&](const auto &list) {
+        for (const auto &row : list) {
+          const auto start = cells.size();
+          with_items(
+              vm,
+              row,
+              "grid() rows must be vectors",
+              [&](const auto &items) {
+                cells.append_range(items);
+                return StackValue{};
+              }
+          );
+          const auto width = cells.size() - start;
+          if (columns && *columns != width) {
+            throw ValueError("grid() rows must all have the same length");
+          }
+          columns = width;
+          ++rows;
+        }
+        return StackValue{};
+      }
+  );
+  return vm.heap_store(Grid{rows, columns.value_or(0), std::move(cells)});
+}
+
+StackValue
+builtin_neighbors(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
+  if (args.size() != 1) {
+    throw TypeError("neighbors() takes exactly 1 argument");
+  }
+
+  const auto grid_opt = args[0].as_grid();
+  if (!grid_opt) {
+    throw TypeError("neighbors() argument must be a grid");
+  }
+  return vm.heap_store(grid_opt->get().neighbors());
+}
+
+StackValue builtin_gmap(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
+  if (args.size() != 2) {
+    throw TypeError("gmap() takes exactly 2 arguments");
+  }
+
+  if (!args[0].is_function()) {
+    throw TypeError("gmap() first argument must be a function");
+  }
+
+  const auto grid_opt = args[1].as_grid();
+  if (!grid_opt) {
+    throw TypeError("gmap() second argument must be a grid");
+  }
+
+  // Functions may write to the grid but never resize it
+  const auto &grid = grid_opt->get();
+  std::vector<StackValue> cells;
+  const l3::vm::BytecodeVM::RootGuard guard{vm, cells};
+  cells.reserve(grid.values().size());
+  for (const auto &cell : grid.values()) {
+    cells.push_back(vm.call_function(args[0], std::array{cell}));
+  }
+  return vm.heap_store(Grid{grid.rows(), grid.columns(), std::move(cells)});
+}
+
+// Keys or values of a dict as a vector, in insertion order
+template <StackValue Dict::Entry::*Member>
+StackValue builtin_dict_items(
+    l3::vm::BytecodeVM &vm, l3::runtime::L3Args args, std::string_view name
+) {
+  if (args.size() != 1) {
+    throw TypeError("{}() takes exactly 1 argument", name);
+  }
+
+  const auto dict_opt = args[0].as_dict();
+  if (!dict_opt) {
+    throw TypeError("{}() argument must be a dict", name);
+  }
+  return vm.heap_store(
+      dict_opt->get().items() |
+      std::views::transform([](const auto &entry) { return entry.*Member; }) |
+      std::ranges::to<std::vector>()
+  );
+}
+
+StackValue builtin_keys(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
+  return builtin_dict_items<&Dict::Entry::key>(vm, args, "keys");
+}
+
+StackValue builtin_values(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
+  return builtin_dict_items<&Dict::Entry::value>(vm, args, "values");
+}
+
+StackValue builtin_has(l3::vm::BytecodeVM & /*vm*/, l3::runtime::L3Args args) {
+  if (args.size() != 2) {
+    throw TypeError("has() takes exactly 2 arguments");
+  }
+
+  if (const auto set_opt = args[0].as_set()) {
+    return {Primitive{set_opt->get().contains(args[1])}};
+  }
+  const auto dict_opt = args[0].as_dict();
+  if (!dict_opt) {
+    throw TypeError("has() first argument must be a dict or a set");
+  }
+  return {Primitive{dict_opt->get().find(args[1]) != nullptr}};
+}
+
+StackValue builtin_set(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
+  if (args.empty()) {
+    return vm.heap_store(Set{});
+  }
+  if (args.size() != 1) {
+    throw TypeError("set() takes at most 1 argument");
+  }
+
+  return with_items(
+      vm,
+      args[0],
+      "set() argument must be a vector",
+      [&](const auto &list) {
+        std::vector<StackValue> values;
+        const l3::vm::BytecodeVM::RootGuard guard{vm, values};
+        std::ranges::copy(list, std::back_inserter(values));
+        return vm.heap_store(Set{values});
+      }
+  );
+}
+
+StackValue builtin_add(l3::vm::BytecodeVM & /*vm*/, l3::runtime::L3Args args) {
+  if (args.size() != 2) {
+    throw TypeError("add() takes exactly 2 arguments");
+  }
+
+  auto *set = as_mut_set(args[0]);
+  if (set == nullptr) {
+    throw TypeError("add() first argument must be a set");
+  }
+  return {Primitive{set->insert(args[1])}};
+}
+
+template <Set (*Operation)(const Set &, const Set &)>
+StackValue builtin_set_operation(
+    l3::vm::BytecodeVM &vm, l3::runtime::L3Args args, std::string_view name
+) {
+  if (args.size() != 2) {
+    throw TypeError("{}() takes exactly 2 arguments", name);
   }
 
-  return {Primitive{count}};
+  const auto lhs_opt = args[0].as_set();
+  const auto rhs_opt = args[1].as_set();
+  if (!lhs_opt || !rhs_opt) {
+    throw TypeError("{}() arguments must be sets", name);
+  }
+  return vm.heap_store(Operation(lhs_opt->get(), rhs_opt->get()));
+}
+
+StackValue builtin_union(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
+  return builtin_set_operation<&Set::unite>(vm, args, "union");
+}
+
+StackValue
+builtin_intersection(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
+  return builtin_set_operation<&Set::intersect>(vm, args, "intersection");
+}
+
+StackValue
+builtin_difference(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
+  return builtin_set_operation<&Set::subtract>(vm, args, "difference");
 }
 
 StackValue
@@ -484,11 +1582,7 @@ StackValue builtin_range(l3::vm::BytecodeVM &vm, l3::runtime::L3Args args) {
     }
   }
 
-  auto result = std::vector<StackValue>{};
-  for (std::int64_t i = start; step > 0 ? i < end : i > end; i += step) {
-    result.push_back(vm.heap_store(Primitive{i}));
-  }
-  return vm.heap_store(std::move(result));
+  return vm.heap_store(l3::runtime::Range::between(start, end, step));
 }
 
 } // namespace
@@ -500,6 +1594,7 @@ const std::initializer_list<std::pair<
         {"print", builtin_print},
         {"println", builtin_println},
         {"__trigger_gc", builtin_trigger_gc},
+        {"gc_stats", builtin_gc_stats},
         {"assert", builtin_assert},
         {"error", builtin_error},
         {"input", builtin_input},
@@ -515,12 +1610,43 @@ const std::initializer_list<std::pair<
         {"sleep", builtin_sleep},
         {"map", builtin_map},
         {"filter", builtin_filter},
+        {"pmap", builtin_pmap},
+        {"pfilter", builtin_pfilter},
+        {"spawn", builtin_spawn},
+        {"await", builtin_await},
         {"sum", builtin_sum},
         {"all", builtin_all},
         {"any", builtin_any},
         {"count", builtin_count},
+        {"reduce", builtin_reduce},
+        {"fold", builtin_fold},
+        {"sort", builtin_sort},
+        {"sort_by", builtin_sort_by},
         {"id", builtin_identity},
+        {"iter", builtin_iter},
+        {"imap", builtin_imap},
+        {"ifilter", builtin_ifilter},
+        {"take_while", builtin_take_while},
+        {"zip", builtin_zip},
+        {"enumerate", builtin_enumerate},
+        {"collect", builtin_collect},
         {"range", builtin_range},
+        {"array", builtin_array},
+        {"vadd", builtin_vadd},
+        {"vsub", builtin_vsub},
+        {"vmul", builtin_vmul},
+        {"veq", builtin_veq},
+        {"grid", builtin_grid},
+        {"neighbors", builtin_neighbors},
+        {"gmap", builtin_gmap},
+        {"keys", builtin_keys},
+        {"values", builtin_values},
+        {"has", builtin_has},
+        {"set", builtin_set},
+        {"add", builtin_add},
+        {"union", builtin_union},
+        {"intersection", builtin_intersection},
+        {"difference", builtin_difference},
     };
 
 } // namespace l3::builtins
@@ -0,0 +1,277 @@
+module l3.vm;
+
+import std;
+
+import l3.runtime;
+
+namespace l3::vm {
+
+namespace {
+
+bool captures_mutable_impl(
+    const runtime::StackValue &value,
+    std::unordered_set<const runtime::HeapCell *> &visited
+) {
+  const auto *cell = value.get_heap_ptr();
+  // Closures capture themselves when they are recursive
+  if (cell == nullptr || !visited.insert(cell).second) {
+    return false;
+  }
+  const auto captures = [&](const runtime::StackValue &captured) {
+    return captures_mutable_impl(captured, visited);
+  };
+  return cell->get_value().visit(
+      [&](const runtime::HeapData::function_type &function) {
+        return function->visit(
+            [&](const runtime::BytecodeFunction &closure) {
+              return closure.get_prototype().captures_mutable ||
+                     std::ranges::any_of(
+                         closure.upvalues(),
+                         [&](runtime::UpvalueCell *upvalue) {
+                           return captures(upvalue->get());
+                         }
+                     );
+            },
+            [&](const runtime::PartialApplication &partial) {
+              return captures(partial.get_target()) ||
+                     std::ranges::any_of(partial.arguments(), captures);
+            },
+            [](const runtime::BuiltinFunction &) { return false; }
+        );
+      },
+      [](const auto &) { return false; }
+  );
+}
+
+} // namespace
+
+bool BytecodeVM::captures_mutable(const runtime::StackValue &function) {
+  std::unordered_set<const runtime::HeapCell *> visited;
+  return captures_mutable_impl(function, visited);
+}
+
+runtime::StackValue
+BytecodeVM::copy_in(const runtime::StackValue &value, Copies &copies) {
+  auto *cell = value.get_heap_ptr();
+  if (cell == nullptr) {
+    return value;
+  }
+  // Strings go through the string table of this VM, equal interned strings
+  // compare by identity
+  if (const auto string = cell->get_value().as_string()) {
+    return heap_store(std::string{*string});
+  }
+  if (cell->is_immortal()) {
+    return value;
+  }
+
+  if (const auto it = copies.find(cell); it != copies.end()) {
+    if (!it->second) {
+      throw runtime::TypeError(
+          "a {} containing itself cannot be passed to another isolate",
+          value.type_name()
+      );
+    }
+    return *it->second;
+  }
+  copies.emplace(cell, std::nullopt);
+
+  const auto copy_all = [&](std::span<const runtime::StackValue> values) {
+    return values |
+           std::views::transform([&](const runtime::StackValue &element) {
+             return copy_in(element, copies);
+           }) |
+           std::ranges::to<std::vector>();
+  };
+
+  auto copy = cell->get_value().visit(
+      [&](const runtime::HeapData::function_type &function) {
+        return function->visit(
+            [&](const runtime::BuiltinFunction &builtin) {
+              return builtins[builtin.get_index()];
+            },
+            [&](const runtime::BytecodeFunction &closure) {
+              const auto &prototype = closure.get_prototype();
+              if (prototype.captures_mutable) {
+                throw runtime::TypeError(
+                    "{} captures a mut variable and cannot be passed to "
+                    "another isolate",
+                    prototype.name
+                );
+              }
+              // Stored before the captured values are copied, recursive
+              // closures capture themselves
+              const auto captured =
+                  closure.upvalues() |
+                  std::views::transform([&](runtime::UpvalueCell *) {
+                    return &upvalues.emplace(runtime::StackValue{});
+                  }) |
+                  std::ranges::to<std::vector>();
+              runtime::BytecodeFunction copied{prototype, captured.size()};
+              std::ranges::copy(captured, copied.upvalues().begin());
+              const auto result =
+                  heap_store(runtime::Function{std::move(copied)});
+              copies[cell] = result;
+
+              for (auto [target, source] :
+                   std::views::zip(captured, closure.upvalues())) {
+                target->get() = copy_in(source->get(), copies);
+              }
+              return result;
+            },
+            [&](const runtime::PartialApplication &partial) {
+              const auto target = copy_in(partial.get_target(), copies);
+              const auto arguments = copy_all(partial.arguments());
+              return heap_store(
+                  runtime::Function{
+                      runtime::PartialApplication{target, arguments, {}}
+                  }
+              );
+            }
+        );
+      },
+      [&](const runtime::Vector &vector) {
+        return heap_store(copy_all(vector.view()));
+      },
+      [&](const runtime::Grid &grid) {
+        return heap_store(
+            runtime::Grid{grid.rows(), grid.columns(), copy_all(grid.values())}
+        );
+      },
+      [&](const runtime::GridRow &row) {
+        const auto grid =
+            copy_in(runtime::StackValue{row.get_grid()}, copies);
+        return heap_store(
+            runtime::GridRow{grid.get_heap_ptr(), row.get_index()}
+        );
+      },
+      [&](const runtime::Dict &dict) {
+        runtime::Dict copied;
+        for (const auto &entry : dict.items()) {
+          copied.insert(
+              copy_in(entry.key, copies), copy_in(entry.value, copies)
+          );
+        }
+        return heap_store(std::move(copied));
+      },
+      [&](const runtime::Set &set) {
+        return heap_store(runtime::Set{copy_all(set.items())});
+      },
+      [&](const runtime::Record &record) {
+        // Shares the shape, which belongs to the program
+        auto copied = record;
+        for (std::size_t slot = 0; slot < copied.size(); ++slot) {
+          copied[slot] = copy_in(record[slot], copies);
+        }
+        return heap_store(std::move(copied));
+      },
+      [](const runtime::Iterator &) -> runtime::StackValue {
+        throw runtime::TypeError(
+            "an iterator cannot be passed to another isolate, collect() it "
+            "first"
+        );
+      },
+      // Ranges, packed arrays and big integers hold no references, futures
+      // share their task
+      [&](const auto &) {
+        return heap_store(runtime::HeapData{cell->get_value()});
+      }
+  );
+  copies[cell] = copy;
+  return copy;
+}
+
+void BytecodeVM::attach(const BytecodeVM &source) {
+  shared_program = source.shared_program;
+  current_program = shared_program.get();
+  load_constants();
+  scheduler = source.scheduler;
+}
+
+void BytecodeVM::run_chunk(
+    const BytecodeVM &source,
+    const runtime::StackValue &function,
+    std::span<const runtime::StackValue> items
+) {
+  attach(source);
+
+  Copies copies;
+  // Kept on the stack as a GC root, like the results
+  const auto callee = copy_in(function, copies);
+  stack.push_back(callee);
+  for (const auto &item : items) {
+    copies.clear();
+    const std::array arguments{copy_in(item, copies)};
+    stack.push_back(call_function(callee, arguments));
+  }
+}
+
+std::vector<runtime::StackValue> BytecodeVM::parallel_map(
+    const runtime::StackValue &function,
+    std::span<const runtime::StackValue> items
+) {
+  if (!shared_program) {
+    throw runtime::RuntimeError("isolates can only be used by a program");
+  }
+  if (items.empty()) {
+    return {};
+  }
+  if (!workers) {
+    workers = std::make_unique<VmPool>(debug);
+  }
+
+  const auto chunk_count = std::clamp(
+      std::size_t{std::thread::hardware_concurrency()}, 1UZ, items.size()
+  );
+  const auto chunk_size = (items.size() + chunk_count - 1) / chunk_count;
+  std::vector<std::span<const runtime::StackValue>> chunks;
+  for (std::size_t start = 0; start < items.size(); start += chunk_size) {
+    chunks.push_back(
+        items.subspan(start, std::min(chunk_size, items.size() - start))
+    );
+  }
+
+  std::vector<VmPool::Lease> leases;
+  leases.reserve(chunks.size());
+  for (std::size_t i = 0; i < chunks.size(); ++i) {
+    leases.push_back(workers->acquire());
+  }
+
+  auto &tasks = task_scheduler();
+  std::vector<std::exception_ptr> errors(chunks.size());
+  std::atomic<std::size_t> remaining = chunks.size();
+  for (std::size_t i = 0; i < chunks.size(); ++i) {
+    tasks.submit(
+        [&, i](std::size_t queue) {
+          leases[i]->scheduler_queue = queue;
+          try {
+            leases[i]->run_chunk(*this, function, chunks[i]);
+          } catch (...) {
+            errors[i] = std::current_exception();
+          }
+          --remaining;
+        },
+        scheduler_queue
+    );
+  }
+  tasks.help_until(scheduler_queue, [&] { return remaining.load() == 0; });
+
+  for (const auto &error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  // The workers are idle, nothing runs while their results are copied
+  std::vector<runtime::StackValue> results;
+  results.reserve(items.size());
+  for (auto &worker : leases) {
+    Copies copies;
+    for (const auto &result : std::span{worker->stack}.subspan(1)) {
+      results.push_back(copy_in(result, copies));
+    }
+  }
+  return results;
+}
+
+} // namespace l3::vm
@@ -0,0 +1,109 @@
+module l3.vm;
+
+import std;
+
+namespace l3::vm {
+
+TaskScheduler::TaskScheduler(std::size_t thread_count)
+    : queues(thread_count + 1) {
+  threads.reserve(thread_count);
+  for (std::size_t queue = 0; queue < thread_count; ++queue) {
+    threads.emplace_back([this, queue] { work(queue); });
+  }
+}
+
+TaskScheduler::~TaskScheduler() {
+  {
+    const std::scoped_lock lock{sleep_mutex};
+    stopping = true;
+  }
+  wake.notify_all();
+}
+
+void TaskScheduler::submit(Job job, std::size_t queue) {
+  ++unfinished;
+  {
+    const std::scoped_lock lock{queues[queue].mutex};
+    queues[queue].jobs.push_back(std::move(job));
+    ++pending;
+  }
+  notify();
+}
+
+std::optional<TaskScheduler::Job> TaskScheduler::pop(std::size_t queue) {
+  auto &own = queues[queue];
+  const std::scoped_lock lock{own.mutex};
+  if (own.jobs.empty()) {
+    return std::nullopt;
+  }
+  auto job = std::move(own.jobs.back());
+  own.jobs.pop_back();
+  --pending;
+  return job;
+}
+
+std::optional<TaskScheduler::Job> TaskScheduler::steal(std::size_t queue) {
+  for (std::size_t offset = 1; offset < queues.size(); ++offset) {
+    auto &victim = queues[(queue + offset) % queues.size()];
+    const std::scoped_lock lock{victim.mutex};
+    if (!victim.jobs.empty()) {
+      auto job = std::move(victim.jobs.front());
+      victim.jobs.pop_front();
+      --pending;
+      return job;
+    }
+  }
+  return std::nullopt;
+}
+
+void TaskScheduler::run(Job &job, std::size_t queue) {
+  job(queue);
+  --unfinished;
+  notify();
+}
+
+void TaskScheduler::notify() {
+  // Taking the lock orders this after the check of a thread about to sleep,
+  // which would otherwise miss the wake-up
+  {
+    const std::scoped_lock lock{sleep_mutex};
+  }
+  wake.notify_all();
+}
+
+void TaskScheduler::help_until(
+    std::size_t queue, std::function<bool()> done
+) {
+  while (!done()) {
+    auto job = pop(queue);
+    if (!job) {
+      job = steal(queue);
+    }
+    if (job) {
+      run(*job, queue);
+      continue;
+    }
+    std::unique_lock lock{sleep_mutex};
+    wake.wait(lock, [&] { return done() || pending.load() > 0; });
+  }
+}
+
+void TaskScheduler::work(std::size_t queue) {
+  while (true) {
+    auto job = pop(queue);
+    if (!job) {
+      job = steal(queue);
+    }
+    if (job) {
+      run(*job, queue);
+      continue;
+    }
+    std::unique_lock lock{sleep_mutex};
+    if (stopping && pending.load() == 0) {
+      return;
+    }
+    wake.wait(lock, [&] { return stopping || pending.load() > 0; });
+  }
+}
+
+} // namespace l3::vm
@@ -0,0 +1,65 @@
+export module l3.vm:scheduler;
+
+import std;
+
+export namespace l3::vm {
+
+// Work-stealing thread pool running the tasks of a program. Every worker
+// thread owns a queue, and one more queue takes jobs submitted from outside
+// the pool. Jobs are told the queue of the thread running them and submit the
+// jobs they create to it: the thread takes the newest job of its own queue,
+// and idle threads steal the oldest jobs of the others.
+class TaskScheduler {
+public:
+  // Jobs handle their own errors, they must not throw
+  using Job = std::move_only_function<void(std::size_t queue)>;
+
+  explicit TaskScheduler(
+      std::size_t thread_count =
+          std::max(1U, std::thread::hardware_concurrency())
+  );
+  TaskScheduler(const TaskScheduler &) = delete;
+  TaskScheduler(TaskScheduler &&) = delete;
+  TaskScheduler &operator=(const TaskScheduler &) = delete;
+  TaskScheduler &operator=(TaskScheduler &&) = delete;
+  // Runs the jobs left, including those they submit, and joins the threads
+  ~TaskScheduler();
+
+  // Queue of the threads outside the pool
+  [[nodiscard]] std::size_t shared_queue() const { return queues.size() - 1; }
+
+  void submit(Job job, std::size_t queue);
+
+  // Runs jobs on the calling thread until `done` returns true, those of
+  // `queue` first and then those stolen from the others, and sleeps while
+  // there are none. Tasks park on an await instead of calling this, see
+  // BytecodeVM::park_await(), so the jobs run here seldom wait themselves.
+  void help_until(std::size_t queue, std::function<bool()> done);
+  // Whether every job submitted so far has finished
+  [[nodiscard]] bool is_idle() const { return unfinished.load() == 0; }
+
+private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Job> jobs;
+  };
+
+  std::optional<Job> pop(std::size_t queue);
+  std::optional<Job> steal(std::size_t queue);
+  void run(Job &job, std::size_t queue);
+  void notify();
+  void work(std::size_t queue);
+
+  std::vector<Queue> queues;
+  // Jobs waiting in a queue, and jobs submitted and not finished yet
+  std::atomic<std::size_t> pending = 0;
+  std::atomic<std::size_t> unfinished = 0;
+  // Guards sleeping, threads are woken when a job is submitted or finished
+  std::mutex sleep_mutex;
+  std::condition_variable wake;
+  bool stopping = false;
+  // Last, so the threads are joined before the queues are destroyed
+  std::vector<std::jthread> threads;
+};
+
+} // namespace l3::vm
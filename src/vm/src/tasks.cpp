@@ -0,0 +1,176 @@
+module l3.vm;
+
+import std;
+
+import l3.bytecode;
+import l3.runtime;
+
+namespace l3::vm {
+
+// A task runs in a VM of its own, which holds the function and its arguments
+// on the stack until the task runs, and its result once it has returned. The
+// VM is left idle then, awaiting VMs copy the result out of it. A task parked
+// on an await is resubmitted by the task it waits for, see park_await().
+struct BytecodeVM::SpawnedTask final
+    : runtime::Task,
+      std::enable_shared_from_this<SpawnedTask> {
+  explicit SpawnedTask(bool debug)
+      : vm{std::make_unique<BytecodeVM>(debug)} {
+    vm->parks_awaits = true;
+  }
+
+  [[nodiscard]] bool is_done() const override {
+    return done.load(std::memory_order_acquire);
+  }
+
+  void run(std::size_t queue) {
+    vm->scheduler_queue = queue;
+    try {
+      if (!vm->awaiting) {
+        // Copied, the call grows the stack
+        const auto function = vm->stack.front();
+        const std::vector arguments(
+            std::next(vm->stack.begin()), vm->stack.end()
+        );
+        const auto result = vm->call_function(function, arguments);
+        if (!vm->awaiting) {
+          vm->stack.push_back(result);
+        }
+      }
+      // Resumed at once when the awaited task is done. The frame of the task
+      // function returns last and leaves the result on top.
+      while (vm->awaiting) {
+        if (vm->awaiting->add_waiter(shared_from_this())) {
+          return;
+        }
+        vm->resume_await();
+        vm->execute_loop(0);
+      }
+    } catch (...) {
+      error = std::current_exception();
+    }
+    finish(queue);
+  }
+
+  // Whether `waiter` is resubmitted once this task is done, false when it is
+  // done already
+  bool add_waiter(std::shared_ptr<SpawnedTask> waiter) {
+    const std::scoped_lock lock{mutex};
+    if (is_done()) {
+      return false;
+    }
+    waiters.push_back(std::move(waiter));
+    return true;
+  }
+
+  void finish(std::size_t queue) {
+    std::vector<std::shared_ptr<SpawnedTask>> resumed;
+    {
+      const std::scoped_lock lock{mutex};
+      done.store(true, std::memory_order_release);
+      resumed = std::exchange(waiters, {});
+    }
+    for (auto &waiter : resumed) {
+      vm->scheduler->submit(
+          [waiter](std::size_t queue) { waiter->run(queue); }, queue
+      );
+    }
+  }
+
+  std::unique_ptr<BytecodeVM> vm;
+  std::exception_ptr error;
+  std::atomic<bool> done = false;
+  // Tasks parked on this one
+  std::mutex mutex;
+  std::vector<std::shared_ptr<SpawnedTask>> waiters;
+};
+
+TaskScheduler &BytecodeVM::task_scheduler() {
+  if (scheduler == nullptr) {
+    owned_scheduler = std::make_unique<TaskScheduler>();
+    scheduler = owned_scheduler.get();
+    scheduler_queue = scheduler->shared_queue();
+  }
+  return *scheduler;
+}
+
+runtime::StackValue BytecodeVM::spawn(
+    const runtime::StackValue &function, runtime::L3Args arguments
+) {
+  if (!shared_program) {
+    throw runtime::RuntimeError("tasks can only be spawned by a program");
+  }
+  auto &tasks = task_scheduler();
+
+  auto task = std::make_shared<SpawnedTask>(debug);
+  auto &vm = *task->vm;
+  vm.attach(*this);
+  // One transfer, values shared by the arguments stay shared in the task
+  Copies copies;
+  vm.stack.push_back(vm.copy_in(function, copies));
+  for (const auto &argument : arguments) {
+    vm.stack.push_back(vm.copy_in(argument, copies));
+  }
+
+  tasks.submit(
+      [task](std::size_t queue) { task->run(queue); }, scheduler_queue
+  );
+  return heap_store(runtime::Future{std::move(task)});
+}
+
+runtime::StackValue BytecodeVM::await(const runtime::Future &future) {
+  // Futures are only created by spawn(), and only reach VMs sharing the
+  // scheduler of the VM that spawned them
+  const auto task = std::static_pointer_cast<SpawnedTask>(future.get_task());
+  scheduler->help_until(scheduler_queue, [&] { return task->is_done(); });
+  return task_result(*task);
+}
+
+runtime::StackValue BytecodeVM::task_result(const SpawnedTask &task) {
+  if (task.error) {
+    std::rethrow_exception(task.error);
+  }
+  // The task VM never runs again, any number of VMs can copy from it at once
+  Copies copies;
+  return copy_in(task.vm->stack.back(), copies);
+}
+
+bool BytecodeVM::park_await(
+    const bytecode::OpCall &op, const runtime::StackValue &function
+) {
+  if (!parks_awaits || function.get_heap_ptr() != await_builtin ||
+      op.arg_count != 1) {
+    return false;
+  }
+  const auto future = stack.back().as_future();
+  if (!future) {
+    return false;
+  }
+  auto task = std::static_pointer_cast<SpawnedTask>(future->get().get_task());
+  if (task->is_done()) {
+    return false;
+  }
+  // Intrinsic frames and the callbacks they call run in a loop of their own
+  if (!std::ranges::all_of(
+          std::views::drop(frames, 1), &CallFrame::returns_to_call
+      )) {
+    return false;
+  }
+
+  debug_print("AWAIT parked");
+  awaiting = std::move(task);
+  awaiting_keeps_result = op.keep_return_value;
+  return true;
+}
+
+void BytecodeVM::resume_await() {
+  const auto task = std::exchange(awaiting, nullptr);
+  // The function and the future of the call
+  stack.resize(stack.size() - 2);
+  const auto result = task_result(*task);
+  if (awaiting_keeps_result) {
+    stack_push(result);
+  }
+}
+
+} // namespace l3::vm
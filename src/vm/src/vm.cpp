@@ -12,12 +12,30 @@ namespace l3::vm {
 
 namespace {
 
+using IntrinsicKind = BytecodeVM::Intrinsic::Kind;
+
+constexpr std::array INTRINSICS{
+    std::pair{std::string_view{"map"}, IntrinsicKind::Map},
+    std::pair{std::string_view{"filter"}, IntrinsicKind::Filter},
+    std::pair{std::string_view{"count"}, IntrinsicKind::Count},
+    std::pair{std::string_view{"reduce"}, IntrinsicKind::Reduce},
+    std::pair{std::string_view{"fold"}, IntrinsicKind::Fold},
+};
+
 std::string function_name_for_frame(const BytecodeVM::CallFrame &frame) {
+  if (frame.intrinsic) {
+    const auto entry = std::ranges::find(
+        INTRINSICS,
+        frame.intrinsic->kind,
+        [](const auto &intrinsic) { return intrinsic.second; }
+    );
+    return std::string{entry->first};
+  }
   if (!frame.closure) {
     return "<toplevel>";
   }
 
-  return frame.closure->first.name;
+  return frame.closure->get_prototype().name;
 }
 
 template <typename Op>
@@ -38,14 +56,113 @@ void unary_op(
   a = vm.heap_store(std::forward<Op>(op)(a));
 }
 
+runtime::Record &record_operand(const runtime::StackValue &value) {
+  if (auto *cell = value.get_heap_ptr()) {
+    if (auto *record =
+            std::get_if<runtime::Record>(&cell->get_value().get_inner())) {
+      return *record;
+    }
+  }
+  throw runtime::TypeError("cannot access a field of a {}", value.type_name());
+}
+
+// Slot of the field at `slot` of `expected` in `record`: the slot itself when
+// the record has that shape, the slot of the field with the same name otherwise
+std::size_t field_slot(
+    const runtime::Record &record,
+    const runtime::RecordShape &expected,
+    std::size_t slot
+) {
+  if (record.has_shape(&expected)) {
+    return slot;
+  }
+  return record.slot_of(expected.fields[slot]);
+}
+
+// Bytecode function run by a call, with the closure holding it and the
+// arguments bound by partial application in front of the call's own
+struct Callee {
+  const runtime::BytecodeFunction *function;
+  runtime::StackValue closure;
+  runtime::L3Args bound;
+};
+
+std::optional<Callee> bytecode_callee(const runtime::StackValue &value) {
+  const auto *cell = value.get_heap_ptr();
+  if (cell == nullptr) {
+    return std::nullopt;
+  }
+  return cell->get_value().visit(
+      [&](const runtime::HeapData::function_type &function) {
+        return function->visit(
+            [&](const runtime::BytecodeFunction &bc_func) {
+              return std::optional{Callee{&bc_func, value, {}}};
+            },
+            [](const runtime::PartialApplication &partial) {
+              auto callee = bytecode_callee(partial.get_target());
+              callee->bound = partial.arguments();
+              return callee;
+            },
+            [](const runtime::BuiltinFunction &) -> std::optional<Callee> {
+              return std::nullopt;
+            }
+        );
+      },
+      [](const auto &) -> std::optional<Callee> { return std::nullopt; }
+  );
+}
+
+// Number of elements of a vector, range, packed array or set
+std::optional<std::size_t> sequence_size(const runtime::StackValue &value) {
+  if (const auto vector_opt = value.as_vector()) {
+    return vector_opt->get().size();
+  }
+  if (const auto range_opt = value.as_range()) {
+    return range_opt->get().size();
+  }
+  if (const auto packed_opt = value.as_packed()) {
+    return packed_opt->get().size();
+  }
+  if (const auto set_opt = value.as_set()) {
+    return set_opt->get().size();
+  }
+  return std::nullopt;
+}
+
+runtime::StackValue
+sequence_at(const runtime::StackValue &value, std::size_t index) {
+  if (const auto vector_opt = value.as_vector()) {
+    return vector_opt->get()[index];
+  }
+  if (const auto range_opt = value.as_range()) {
+    return range_opt->get()[index];
+  }
+  if (const auto set_opt = value.as_set()) {
+    return set_opt->get()[index];
+  }
+  return value.as_packed()->get()[index];
+}
+
+// A value copied out of a local may alias it, so its cell can no longer be
+// appended to in place
+void share(const runtime::StackValue &value) {
+  value.visit(
+      [](runtime::HeapCell *cell) {
+        if (cell->is_exclusive()) {
+          cell->share();
+        }
+      },
+      [](const auto &) {}
+  );
+}
+
 template <typename Pred>
 void compare_op(
     std::vector<runtime::StackValue> &stack, Pred &&pred, bool keep_rhs
 ) {
   auto &a = stack[stack.size() - 2];
   auto &b = stack.back();
-  auto result =
-      runtime::Primitive{std::forward<Pred>(pred)(runtime::compare(a, b))};
+  auto result = runtime::Primitive{std::forward<Pred>(pred)(a, b)};
   if (keep_rhs) {
     a = b;
     b = result;
@@ -58,19 +175,28 @@ void compare_op(
 } // namespace
 
 BytecodeVM::BytecodeVM(bool debug_) : debug(debug_) {
-  for (const auto &[name, body] : l3::builtins::BUILTINS) {
+  builtins.reserve(l3::builtins::BUILTINS.size());
+  for (const auto &[index, builtin] :
+       std::views::enumerate(l3::builtins::BUILTINS)) {
+    const auto &name = builtin.first;
     auto func = heap_store(
         runtime::Function{runtime::BuiltinFunction{
-            ast::Identifier{std::string(name)},
-            [this, body](runtime::L3Args args) -> runtime::StackValue {
-              return body(*this, args);
-            }
+            ast::Identifier{std::string(name)}, static_cast<std::size_t>(index)
         }}
     );
+    builtins.push_back(func);
     define_global(name, func);
   }
+  for (const auto &[name, kind] : INTRINSICS) {
+    intrinsics.emplace_back(
+        global_symbols.find(name)->second.get_heap_ptr(), kind
+    );
+  }
+  await_builtin = global_symbols.find("await")->second.get_heap_ptr();
 }
 
+BytecodeVM::~BytecodeVM() = default;
+
 runtime::StackValue BytecodeVM::heap_store(runtime::HeapData &&value) {
   if (std::holds_alternative<runtime::Nil>(value.get_inner())) {
     return {};
@@ -108,6 +234,25 @@ BytecodeVM::resolve_global(std::string_view name) const {
   return std::nullopt;
 }
 
+std::string_view BytecodeVM::global_name(std::size_t name_index) const {
+  const auto name = constants[name_index].as_string();
+  if (!name) {
+    throw runtime::RuntimeError("global name constant is not a string");
+  }
+  return *name;
+}
+
+runtime::StackValue *BytecodeVM::global_slot(std::size_t name_index) {
+  auto &slot = global_slots[name_index];
+  if (slot == nullptr) {
+    if (auto it = global_symbols.find(global_name(name_index));
+        it != global_symbols.end()) {
+      slot = &it->second;
+    }
+  }
+  return slot;
+}
+
 void BytecodeVM::define_global(
     std::string_view name, runtime::StackValue value
 ) {
@@ -149,6 +294,19 @@ void BytecodeVM::debug_print(std::format_string<Args...> fmt, Args &&...args) {
   }
 }
 
+runtime::StackValue BytecodeVM::call_builtin(
+    const runtime::BuiltinFunction &builtin, runtime::L3Args arguments
+) {
+  // Frames the builtin enters sit on its C++ stack, their awaits cannot park.
+  // A builtin that throws ends its task, which never parks again.
+  const auto parks = std::exchange(parks_awaits, false);
+  auto result = std::data(l3::builtins::BUILTINS)[builtin.get_index()].second(
+      *this, arguments
+  );
+  parks_awaits = parks;
+  return result;
+}
+
 runtime::StackValue BytecodeVM::call_function_impl(
     const runtime::StackValue &function,
     runtime::L3Args arguments,
@@ -163,24 +321,31 @@ runtime::StackValue BytecodeVM::call_function_impl(
       [&](const runtime::HeapData::function_type &f) {
         return f->visit(
             [&](const runtime::BuiltinFunction &builtin_function) {
-              return builtin_function.invoke(arguments);
+              return call_builtin(builtin_function, arguments);
             },
-            [&](const runtime::BytecodeFunction &bc_func) {
-              auto total_args = bc_func.curried_args.size() + arguments.size();
+            [&](const auto &) {
+              const auto callee = *bytecode_callee(function);
+              const auto arity = callee.function->get_prototype().arity;
+              auto total_args = callee.bound.size() + arguments.size();
 
-              if (total_args > bc_func.arity) {
+              if (total_args > arity) {
                 throw runtime::RuntimeError("call_function arity mismatch");
               }
 
-              if (total_args < bc_func.arity) {
-                auto new_func = bc_func;
-                new_func.curried_args.append_range(arguments);
-                return heap_store(runtime::Function{std::move(new_func)});
+              // Partials bind to the closure itself, never to another partial
+              if (total_args < arity) {
+                return heap_store(runtime::Function{runtime::PartialApplication{
+                    callee.closure, callee.bound, arguments
+                }});
               }
 
               auto previous_frames = frames.size();
-              stack_setup(bc_func);
+              stack_setup(callee);
               execute_loop(previous_frames);
+              // The task resumes the frames, see park_await()
+              if (awaiting) {
+                return runtime::StackValue{};
+              }
               return stack_pop();
             }
         );
@@ -199,57 +364,97 @@ runtime::StackValue BytecodeVM::call_function(
     const location::Location &call_location
 ) {
   return call_function_impl(
-      function, arguments, [&](const runtime::BytecodeFunction &bc_func) {
-        auto &new_frame = frames.emplace_back(
-            bc_func.id,
+      function, arguments, [&](const Callee &callee) {
+        frames.emplace_back(
+            callee.function->get_prototype().id,
             0,
             stack.size(),
             call_location,
-            std::pair{bc_func, function}
-        );
-        new_frame.upvalues = bc_func.captured_upvalue_refs;
-        stack.reserve(
-            stack.size() + bc_func.curried_args.size() + arguments.size()
+            callee.function,
+            callee.closure,
+            callee.function->upvalues()
         );
-        stack.append_range(bc_func.curried_args);
+        stack.reserve(stack.size() + callee.bound.size() + arguments.size());
+        stack.append_range(callee.bound);
         stack.append_range(arguments);
       }
   );
 }
 
 std::size_t BytecodeVM::run_gc() {
-  static const auto mark_stack_value = [](runtime::StackValue &sv) {
+  using clock = std::chrono::steady_clock;
+  const auto start = clock::now();
+
+  gray_cells.clear();
+  gray_upvalues.clear();
+
+  const auto add_root = [this](runtime::StackValue &sv) {
     if (auto *gcv = sv.get_heap_ptr()) {
-      gcv->mark();
+      gray_cells.push_back(gcv);
     }
   };
 
   for (auto &sv : stack) {
-    mark_stack_value(sv);
+    add_root(sv);
   }
   for (auto &[_, sv] : global_symbols) {
-    if (auto *gcv = sv.get_heap_ptr()) {
-      gcv->mark();
+    add_root(sv);
+  }
+  for (auto &sv : builtins) {
+    add_root(sv);
+  }
+  for (auto *values : scratch_roots) {
+    for (auto &sv : *values) {
+      add_root(sv);
     }
   }
+  gray_cells.append_range(pinned_constants);
   for (auto &frame : frames) {
-    if (frame.closure && frame.closure->second.holds_heap_cell()) {
-      frame.closure->second.get_heap_ptr()->mark();
-    }
-    for (auto *uv : frame.upvalues) {
-      uv->mark();
+    add_root(frame.callee);
+    if (frame.intrinsic) {
+      auto &state = *frame.intrinsic;
+      add_root(state.callback);
+      add_root(state.source);
+      add_root(state.current);
+      add_root(state.accumulator);
+      for (auto &sv : state.results) {
+        add_root(sv);
+      }
     }
     for (auto &[_, uv] : frame.captured_locals) {
-      uv->mark();
+      gray_upvalues.push_back(uv);
     }
   }
-  if (current_program != nullptr) {
-    for (auto &gc_val : current_program->constants) {
-      gc_val.mark();
-    }
+  const auto roots_done = clock::now();
+
+  for (auto *gcv : gray_cells) {
+    gcv->mark();
+  }
+  for (auto *uv : gray_upvalues) {
+    uv->mark();
   }
-  heap.sweep();
-  return upvalues.sweep();
+  const auto mark_done = clock::now();
+
+  const auto swept = heap.sweep();
+  const auto upvalues_freed = upvalues.sweep();
+  const auto sweep_done = clock::now();
+
+  gc_stats.collections++;
+  gc_stats.roots_time += roots_done - start;
+  gc_stats.mark_time += mark_done - roots_done;
+  gc_stats.sweep_time += sweep_done - mark_done;
+  gc_stats.max_pause = std::max<runtime::GcStats::duration>(
+      gc_stats.max_pause, sweep_done - start
+  );
+  gc_stats.cells_freed += swept.cells;
+  gc_stats.bytes_freed += swept.bytes;
+  gc_stats.upvalues_freed += upvalues_freed;
+  gc_stats.cells_surviving = heap.get_size();
+  gc_stats.upvalues_surviving = upvalues.get_size();
+  gc_stats.heap_chunks = heap.chunk_count();
+  gc_stats.upvalue_chunks = upvalues.chunk_count();
+
+  return upvalues_freed;
 }
 
 void BytecodeVM::maybe_gc() {
@@ -258,8 +463,44 @@ void BytecodeVM::maybe_gc() {
   }
 }
 
-void BytecodeVM::execute(bytecode::ProgramBytecode &program) {
-  current_program = &program;
+void BytecodeVM::load_constants() {
+  const auto &program = *current_program;
+  constants.clear();
+  pinned_constants.clear();
+  constants.reserve(program.constant_values.size());
+
+  for (runtime::StackValue value : program.constant_values) {
+    if (!value.is_string()) {
+      constants.push_back(value);
+      continue;
+    }
+    // Equal strings share one cell, so string constants compare by identity
+    auto &canonical = heap.intern_constant(*value.get_heap_ptr());
+    if (!canonical.is_immortal()) {
+      pinned_constants.push_back(&canonical);
+    }
+    constants.emplace_back(&canonical);
+  }
+
+  global_slots.assign(constants.size(), nullptr);
+}
+
+void BytecodeVM::release_constants() {
+  for (const auto &cell : current_program->constants) {
+    if (cell.get_value().is_string()) {
+      heap.release_constant(cell);
+    }
+  }
+  constants.clear();
+  pinned_constants.clear();
+  global_slots.clear();
+  current_program = nullptr;
+}
+
+void BytecodeVM::execute(bytecode::SharedProgram program) {
+  shared_program = std::move(program);
+  current_program = shared_program.get();
+  load_constants();
   frames.emplace_back();
   try {
     execute_loop(0);
@@ -280,18 +521,41 @@ void BytecodeVM::execute(bytecode::ProgramBytecode &program) {
         }) |
         std::ranges::to<std::vector>();
     error.set_stacktrace(std::move(stacktrace));
-    current_program = nullptr;
+    release_constants();
     throw;
   }
-  current_program = nullptr;
+  // Tasks nobody awaited still run, the program ends with them
+  if (owned_scheduler) {
+    owned_scheduler->help_until(scheduler_queue, [this] {
+      return owned_scheduler->is_idle();
+    });
+  }
+  release_constants();
+  stack.clear();
+}
+
+void BytecodeVM::reset() {
+  if (current_program != nullptr) {
+    release_constants();
+  }
+  frames.clear();
   stack.clear();
+  shared_program.reset();
+  // A worker VM forgets the scheduler it borrowed
+  scheduler = owned_scheduler.get();
+  for (const auto &[builtin, value] :
+       std::views::zip(l3::builtins::BUILTINS, builtins)) {
+    global_symbols.find(builtin.first)->second = value;
+  }
+  run_gc();
+  gc_stats = {};
 }
 
 void BytecodeVM::execute_loop(std::size_t target_frames) {
   const auto &program = *current_program;
   const auto &chunks = program.chunks;
 
-  while (frames.size() > target_frames) {
+  while (frames.size() > target_frames && !awaiting) {
     maybe_gc();
     auto &frame = frames.back();
     const auto &chunk = chunks[frame.chunk_id];
@@ -307,19 +571,30 @@ void BytecodeVM::execute_loop(std::size_t target_frames) {
 }
 
 void BytecodeVM::
-    execute_op(const bytecode::OpReturn & /*op*/, CallFrame & /*frame*/) {
+    execute_op(const bytecode::OpReturn & /*op*/, CallFrame &frame) {
   debug_print("RETURN value={}", stack_top());
+  if (frame.returns_to_call) {
+    const auto result = stack_pop();
+    const auto keep_return_value = frame.keep_return_value;
+    stack.erase(
+        stack.begin() + static_cast<std::ptrdiff_t>(frame.frame_pointer - 1),
+        stack.end()
+    );
+    frames.pop_back();
+    if (keep_return_value) {
+      stack_push(result);
+    }
+    return;
+  }
   frames.pop_back();
+  if (!frames.empty() && frames.back().intrinsic) [[unlikely]] {
+    resume_intrinsic();
+  }
 }
 
 void BytecodeVM::
     execute_op(const bytecode::OpConstant &op, CallFrame & /*frame*/) {
-  runtime::HeapCell &chunk_val = constant_at(op.index);
-  chunk_val.get_value().visit(
-      [&](runtime::Nil) { stack.emplace_back(); },
-      [&](runtime::Primitive p) { stack.emplace_back(p); },
-      [&](const auto &) { stack.emplace_back(&chunk_val); }
-  );
+  stack.push_back(constants[op.index]);
   debug_print("CONSTANT index={} value={}", op.index, stack_top());
 }
 
@@ -340,6 +615,7 @@ void BytecodeVM::execute_op(const bytecode::OpPop &op, CallFrame & /*frame*/) {
 void BytecodeVM::
     execute_op(const bytecode::OpDuplicate &op, CallFrame & /*frame*/) {
   debug_print("DUPLICATE value={}", stack_top(op.index));
+  share(stack_top(op.index));
   stack.push_back(stack_top(op.index));
 }
 
@@ -396,7 +672,7 @@ void BytecodeVM::
   debug_print("EQUAL a={} b={}", stack_top(1), stack_top());
   compare_op(
       stack,
-      [](auto cmp) { return cmp == std::partial_ordering::equivalent; },
+      [](const auto &a, const auto &b) { return runtime::equals(a, b); },
       op.keep_rhs
   );
 }
@@ -406,7 +682,7 @@ void BytecodeVM::
   debug_print("NOT_EQUAL a={} b={}", stack_top(1), stack_top());
   compare_op(
       stack,
-      [](auto cmp) { return cmp != std::partial_ordering::equivalent; },
+      [](const auto &a, const auto &b) { return !runtime::equals(a, b); },
       op.keep_rhs
   );
 }
@@ -416,7 +692,9 @@ void BytecodeVM::
   debug_print("GREATER a={} b={}", stack_top(1), stack_top());
   compare_op(
       stack,
-      [](auto cmp) { return cmp == std::partial_ordering::greater; },
+      [](const auto &a, const auto &b) {
+        return runtime::compare(a, b) == std::partial_ordering::greater;
+      },
       op.keep_rhs
   );
 }
@@ -426,7 +704,8 @@ void BytecodeVM::
   debug_print("GREATER_EQUAL a={} b={}", stack_top(1), stack_top());
   compare_op(
       stack,
-      [](auto cmp) {
+      [](const auto &a, const auto &b) {
+        const auto cmp = runtime::compare(a, b);
         return cmp == std::partial_ordering::greater ||
                cmp == std::partial_ordering::equivalent;
       },
@@ -438,7 +717,9 @@ void BytecodeVM::execute_op(const bytecode::OpLess &op, CallFrame & /*frame*/) {
   debug_print("LESS a={} b={}", stack_top(1), stack_top());
   compare_op(
       stack,
-      [](auto cmp) { return cmp == std::partial_ordering::less; },
+      [](const auto &a, const auto &b) {
+        return runtime::compare(a, b) == std::partial_ordering::less;
+      },
       op.keep_rhs
   );
 }
@@ -448,7 +729,8 @@ void BytecodeVM::
   debug_print("LESS_EQUAL a={} b={}", stack_top(1), stack_top());
   compare_op(
       stack,
-      [](auto cmp) {
+      [](const auto &a, const auto &b) {
+        const auto cmp = runtime::compare(a, b);
         return cmp == std::partial_ordering::less ||
                cmp == std::partial_ordering::equivalent;
       },
@@ -485,42 +767,32 @@ void BytecodeVM::
 
 void BytecodeVM::
     execute_op(const bytecode::OpGetGlobal &op, CallFrame & /*frame*/) {
-  auto &name_gcv = constant_at(op.name_index);
-  name_gcv.get_value().visit(
-      [&](const std::string &name) {
-        const auto slot = resolve_global(name);
-        if (!slot) {
-          throw runtime::UndefinedVariableError("{}", name);
-        }
-        const auto &sv = *slot;
-        debug_print("GET_GLOBAL name={} value={}", name, sv);
-        stack.push_back(sv);
-      },
-      [](const auto &) {
-        throw runtime::RuntimeError("OpGetGlobal: constant is not a string");
-      }
+  const auto *slot = global_slot(op.name_index);
+  if (slot == nullptr) {
+    throw runtime::UndefinedVariableError("{}", global_name(op.name_index));
+  }
+  debug_print(
+      "GET_GLOBAL name={} value={}", global_name(op.name_index), *slot
   );
+  stack.push_back(*slot);
 }
 
 void BytecodeVM::
     execute_op(const bytecode::OpSetGlobal &op, CallFrame & /*frame*/) {
-  auto &name_gcv = constant_at(op.name_index);
-  name_gcv.get_value().visit(
-      [&](const std::string &name) {
-        auto slot = resolve_global(name);
-        if (!slot) {
-          throw runtime::RuntimeError("Undefined variable: {}", name);
-        }
-        debug_print("SET_GLOBAL name={} value={}", name, stack_top());
-        *slot = stack_pop();
-      },
-      [](const auto &) {
-        throw runtime::RuntimeError("OpSetGlobal: constant is not a string");
-      }
+  auto *slot = global_slot(op.name_index);
+  if (slot == nullptr) {
+    throw runtime::RuntimeError(
+        "Undefined variable: {}", global_name(op.name_index)
+    );
+  }
+  debug_print(
+      "SET_GLOBAL name={} value={}", global_name(op.name_index), stack_top()
   );
+  *slot = stack_pop();
 }
 
 void BytecodeVM::execute_op(const bytecode::OpGetLocal &op, CallFrame &frame) {
+  share(stack_at(frame.frame_pointer + op.index));
   stack.push_back(stack_at(frame.frame_pointer + op.index));
   debug_print(
       "GET_LOCAL index={} fp={} stack size={} value={}",
@@ -541,6 +813,40 @@ void BytecodeVM::execute_op(const bytecode::OpSetLocal &op, CallFrame &frame) {
   }
 }
 
+// `x += y` always behaves as `x = x + y`: no other variable or container ever
+// observes the change. The first append copies into a fresh cell that only
+// the local references; later appends extend that cell in place until the
+// local is read or captured.
+void BytecodeVM::
+    execute_op(const bytecode::OpAddAssign &op, CallFrame &frame) {
+  debug_print("ADD_ASSIGN index={} value={}", op.index, stack_top());
+  auto &target = stack_at(frame.frame_pointer + op.index);
+  const auto captured = frame.captured_locals.contains(op.index);
+
+  auto *cell = target.get_heap_ptr();
+  if (cell != nullptr && cell->is_exclusive() && !captured) {
+    runtime::add_assign(cell->get_value(), stack_top());
+    stack.pop_back();
+    return;
+  }
+
+  auto result = heap_store(runtime::add(target, stack_top()));
+  stack.pop_back();
+  if (auto *result_cell = result.get_heap_ptr()) {
+    // Interned strings are shared by construction, BigInt sums are replaced
+    // rather than updated since they may fit in an int again
+    if (!captured && !result_cell->is_interned() &&
+        !result_cell->get_value().is_bigint()) {
+      result_cell->make_exclusive();
+    }
+  }
+
+  stack_at(frame.frame_pointer + op.index) = result;
+  if (captured) {
+    frame.captured_locals.at(op.index)->get() = result;
+  }
+}
+
 void BytecodeVM::execute_op(const bytecode::OpForLoop &op, CallFrame &frame) {
   const auto control_slot = frame.frame_pointer + op.control_index;
   const auto limit_slot = frame.frame_pointer + op.limit_index;
@@ -587,14 +893,36 @@ void BytecodeVM::execute_op(const bytecode::OpForLoop &op, CallFrame &frame) {
 void BytecodeVM::
     execute_op(const bytecode::OpMakeArray &op, CallFrame & /*frame*/) {
   const auto start = stack.size() - op.count;
+  debug_print("MAKE_ARRAY count={}", op.count);
+
+  // Literals of ints, doubles or bools only are stored unboxed
+  auto packed = runtime::PackedArray::pack(std::span{stack}.subspan(start));
+  if (packed) {
+    stack.resize(start);
+    stack_push(heap_store(std::move(*packed)));
+    return;
+  }
+
   std::vector<runtime::StackValue> elements{
       stack.begin() + static_cast<std::ptrdiff_t>(start), stack.end()
   };
   stack.resize(start);
-  debug_print("MAKE_ARRAY count={}", op.count);
   stack_push(heap_store(std::move(elements)));
 }
 
+void BytecodeVM::
+    execute_op(const bytecode::OpMakeDict &op, CallFrame & /*frame*/) {
+  const auto start = stack.size() - (2 * op.count);
+  debug_print("MAKE_DICT count={}", op.count);
+
+  runtime::Dict dict;
+  for (std::size_t i = start; i < stack.size(); i += 2) {
+    dict.insert(stack[i], stack[i + 1]);
+  }
+  stack.resize(start);
+  stack_push(heap_store(std::move(dict)));
+}
+
 void BytecodeVM::
     execute_op(const bytecode::OpGetIndex & /*op*/, CallFrame & /*frame*/) {
   auto &index_sv = stack.back();
@@ -606,6 +934,18 @@ void BytecodeVM::
   stack.back() = runtime::index(array_sv, index_sv, heap);
 }
 
+void BytecodeVM::
+    execute_op(const bytecode::OpGetElement & /*op*/, CallFrame & /*frame*/) {
+  const auto position_sv = stack_pop();
+  auto &collection_sv = stack.back();
+
+  debug_print(
+      "GET_ELEMENT collection={} position={}", collection_sv, position_sv
+  );
+
+  collection_sv = runtime::element(collection_sv, position_sv, heap);
+}
+
 void BytecodeVM::
     execute_op(const bytecode::OpSetIndex & /*op*/, CallFrame & /*frame*/) {
   auto value_sv = stack_pop();
@@ -620,6 +960,41 @@ void BytecodeVM::
   stack.pop_back();
 }
 
+void BytecodeVM::
+    execute_op(const bytecode::OpMakeRecord &op, CallFrame & /*frame*/) {
+  const auto &shape = current_program->records[op.record];
+  const auto start = stack.size() - shape->fields.size();
+  debug_print("MAKE_RECORD {}", shape->name);
+
+  std::vector<runtime::StackValue> values{
+      stack.begin() + static_cast<std::ptrdiff_t>(start), stack.end()
+  };
+  stack.resize(start);
+  stack_push(heap_store(runtime::Record{shape, std::move(values)}));
+}
+
+void BytecodeVM::
+    execute_op(const bytecode::OpGetField &op, CallFrame & /*frame*/) {
+  auto &record_sv = stack.back();
+  debug_print("GET_FIELD record={} slot={}", record_sv, op.slot);
+
+  const auto &record = record_operand(record_sv);
+  record_sv =
+      record[field_slot(record, *current_program->records[op.record], op.slot)];
+}
+
+void BytecodeVM::
+    execute_op(const bytecode::OpSetField &op, CallFrame & /*frame*/) {
+  auto value_sv = stack_pop();
+  auto &record_sv = stack.back();
+  debug_print("SET_FIELD record={} value={}", record_sv, value_sv);
+
+  auto &record = record_operand(record_sv);
+  record[field_slot(record, *current_program->records[op.record], op.slot)] =
+      value_sv;
+  stack.pop_back();
+}
+
 void BytecodeVM::execute_op(const bytecode::OpCall &op, CallFrame & /*frame*/) {
   const auto base = stack.size() - op.arg_count;
   auto function = stack[base - 1];
@@ -629,6 +1004,38 @@ void BytecodeVM::execute_op(const bytecode::OpCall &op, CallFrame & /*frame*/) {
 
   debug_print("CALL func={} argc={}", function, op.arg_count);
 
+  if (call_intrinsic(op, function) || park_await(op, function)) {
+    return;
+  }
+
+  // Bytecode functions given all their arguments run in this loop, the frame
+  // returns through OpReturn. Builtins and partial applications are called
+  // from here.
+  if (const auto callee = bytecode_callee(function);
+      callee && callee->bound.size() + op.arg_count ==
+                    callee->function->get_prototype().arity) {
+    frames.push_back(
+        CallFrame{
+            .chunk_id = callee->function->get_prototype().id,
+            .ip = 0,
+            .frame_pointer = base,
+            .call_location = current_instruction_location(),
+            .closure = callee->function,
+            .callee = callee->closure,
+            .upvalues = callee->function->upvalues(),
+            .returns_to_call = true,
+            .keep_return_value = op.keep_return_value
+        }
+    );
+    // Bound arguments come first, ahead of those already pushed
+    stack.insert(
+        stack.begin() + static_cast<std::ptrdiff_t>(base),
+        callee->bound.begin(),
+        callee->bound.end()
+    );
+    return;
+  }
+
   const auto cleanup = [this, base]() {
     stack.erase(
         stack.begin() + static_cast<std::ptrdiff_t>(base - 1), stack.end()
@@ -637,32 +1044,7 @@ void BytecodeVM::execute_op(const bytecode::OpCall &op, CallFrame & /*frame*/) {
 
   runtime::StackValue result;
   try {
-    result = call_function_impl(
-        function, args_span, [&](const runtime::BytecodeFunction &bc_func) {
-          auto &new_frame = frames.emplace_back(
-              bc_func.id,
-              0,
-              base,
-              current_instruction_location(),
-              std::pair{bc_func, function}
-          );
-          new_frame.upvalues = bc_func.captured_upvalue_refs;
-
-          if (!bc_func.curried_args.empty()) {
-            const auto curried_count = bc_func.curried_args.size();
-            stack.resize(stack.size() + curried_count);
-
-            for (std::size_t i = op.arg_count; i > 0; i--) {
-              stack[base + i - 1 + curried_count] = stack[base + i - 1];
-            }
-
-            for (const auto &[i, arg] :
-                 utils::ranges::enumerate(bc_func.curried_args)) {
-              stack[base + i] = arg;
-            }
-          }
-        }
-    );
+    result = call_function(function, args_span);
   } catch (...) {
     cleanup();
     throw;
@@ -675,40 +1057,195 @@ void BytecodeVM::execute_op(const bytecode::OpCall &op, CallFrame & /*frame*/) {
   }
 }
 
-void BytecodeVM::execute_op(const bytecode::OpClosure &op, CallFrame &frame) {
-  auto &constant = current_program->constants[op.function_index];
-  auto *func_ptr = constant.get_value().visit(
-      [](runtime::HeapData::function_type &f) -> runtime::BytecodeFunction * {
-        if (auto bc_opt = f->as_mut_bytecode_function()) {
-          return &bc_opt->get();
-        }
-        return nullptr;
-      },
-      [](const auto &) -> runtime::BytecodeFunction * { return nullptr; }
+bool BytecodeVM::call_intrinsic(
+    const bytecode::OpCall &op, const runtime::StackValue &function
+) {
+  const auto intrinsic = std::ranges::find(
+      intrinsics,
+      function.get_heap_ptr(),
+      [](const auto &intrinsic) { return intrinsic.first; }
   );
+  if (intrinsic == intrinsics.end()) {
+    return false;
+  }
+  const auto kind = intrinsic->second;
+  const auto accumulates =
+      kind == IntrinsicKind::Reduce || kind == IntrinsicKind::Fold;
+  if (op.arg_count != (kind == IntrinsicKind::Fold ? 3 : 2)) {
+    return false;
+  }
 
-  if (func_ptr == nullptr) {
-    throw runtime::RuntimeError("OpClosure: constant is not a function");
+  const auto base = stack.size() - op.arg_count;
+  const auto callback = stack[base];
+  const auto source = stack.back();
+
+  // Builtin callbacks, partial application and invalid arguments are left to
+  // the builtin
+  const auto callee = bytecode_callee(callback);
+  if (!callee || callee->bound.size() + (accumulates ? 2 : 1) !=
+                     callee->function->get_prototype().arity) {
+    return false;
+  }
+  const auto size = sequence_size(source);
+  if (!size || (kind == IntrinsicKind::Reduce && *size == 0)) {
+    return false;
+  }
+
+  Intrinsic state{.kind = kind, .callback = callback, .source = source};
+  if (kind == IntrinsicKind::Fold) {
+    state.accumulator = stack[base + 1];
+  } else if (kind == IntrinsicKind::Reduce) {
+    state.accumulator = sequence_at(source, 0);
+    state.index = 1;
   }
 
-  auto &function = *func_ptr;
+  // The driving frame resumes at the instruction after the call, so errors
+  // raised while it is on top are located at the call
+  const auto previous_frames = frames.size();
+  frames.push_back(
+      CallFrame{
+          .chunk_id = current_frame().chunk_id,
+          .ip = current_frame().ip,
+          .frame_pointer = stack.size(),
+          .call_location = current_instruction_location(),
+          .intrinsic = std::move(state)
+      }
+  );
+
+  try {
+    advance_intrinsic();
+    execute_loop(previous_frames);
+  } catch (...) {
+    stack.erase(
+        stack.begin() + static_cast<std::ptrdiff_t>(base - 1), stack.end()
+    );
+    throw;
+  }
+
+  auto result = stack_pop();
+  stack.erase(
+      stack.begin() + static_cast<std::ptrdiff_t>(base - 1), stack.end()
+  );
+  if (op.keep_return_value) {
+    stack_push(result);
+  }
+  return true;
+}
 
-  for (const auto &[local, index] : op.upvalues) {
-    if (local) {
-      auto it = frame.captured_locals.find(index);
-      if (it == frame.captured_locals.end()) {
-        it = frame.captured_locals
-                 .emplace(index, &upvalues.emplace(stack_local(index)))
-                 .first;
+void BytecodeVM::advance_intrinsic() {
+  auto &state = *frames.back().intrinsic;
+
+  if (state.index >= sequence_size(state.source).value_or(0)) {
+    runtime::StackValue result;
+    switch (state.kind) {
+    case IntrinsicKind::Map:
+      result = heap_store(std::move(state.results));
+      break;
+    case IntrinsicKind::Filter:
+      // Filtering a set keeps a set
+      if (state.source.as_set()) {
+        result = heap_store(runtime::Set{state.results});
+      } else {
+        result = heap_store(std::move(state.results));
       }
-      function.captured_upvalue_refs.push_back(it->second);
-    } else {
-      function.captured_upvalue_refs.push_back(
-          frame.closure->first.captured_upvalue_refs[index]
-      );
+      break;
+    case IntrinsicKind::Count:
+      result = runtime::Primitive{state.count};
+      break;
+    case IntrinsicKind::Reduce:
+    case IntrinsicKind::Fold:
+      result = state.accumulator;
+      break;
+    }
+    frames.pop_back();
+    stack_push(result);
+    return;
+  }
+
+  state.current = sequence_at(state.source, state.index++);
+
+  const auto callee = *bytecode_callee(state.callback);
+  const auto &function = *callee.function;
+  const auto frame_pointer = stack.size();
+  stack.append_range(callee.bound);
+  if (state.kind == IntrinsicKind::Reduce ||
+      state.kind == IntrinsicKind::Fold) {
+    stack_push(state.accumulator);
+  }
+  stack_push(state.current);
+
+  // `state` is invalidated once the frame is added
+  auto call_location = frames.back().call_location;
+  frames.emplace_back(
+      function.get_prototype().id,
+      0,
+      frame_pointer,
+      std::move(call_location),
+      &function,
+      callee.closure,
+      function.upvalues()
+  );
+}
+
+void BytecodeVM::resume_intrinsic() {
+  auto &driver = frames.back();
+  auto &state = *driver.intrinsic;
+
+  const auto value = stack_pop();
+  stack.erase(
+      stack.begin() + static_cast<std::ptrdiff_t>(driver.frame_pointer),
+      stack.end()
+  );
+
+  switch (state.kind) {
+  case IntrinsicKind::Map:
+    state.results.push_back(value);
+    break;
+  case IntrinsicKind::Filter:
+    if (value.is_truthy()) {
+      state.results.push_back(state.current);
+    }
+    break;
+  case IntrinsicKind::Count:
+    if (value.is_truthy()) {
+      ++state.count;
+    }
+    break;
+  case IntrinsicKind::Reduce:
+  case IntrinsicKind::Fold:
+    state.accumulator = value;
+    break;
+  }
+
+  advance_intrinsic();
+}
+
+void BytecodeVM::execute_op(const bytecode::OpClosure &op, CallFrame &frame) {
+  const auto callee = bytecode_callee(constants[op.function_index]);
+  if (!callee) {
+    throw runtime::RuntimeError("OpClosure: constant is not a function");
+  }
+
+  // Only the upvalue pointers are filled in, the prototype is shared
+  runtime::BytecodeFunction function{
+      callee->function->get_prototype(), op.upvalues.size()
+  };
+  for (auto &&[upvalue, captured] :
+       std::views::zip(op.upvalues, function.upvalues())) {
+    const auto index = upvalue.index;
+    if (!upvalue.is_local) {
+      captured = frame.upvalues[index];
+      continue;
+    }
+    auto it = frame.captured_locals.find(index);
+    if (it == frame.captured_locals.end()) {
+      it = frame.captured_locals
+               .emplace(index, &upvalues.emplace(stack_local(index)))
+               .first;
     }
+    captured = it->second;
   }
-  stack_push(heap_store(std::move(function)));
+  stack_push(heap_store(runtime::Function{std::move(function)}));
   debug_print("CLOSURE function={}", stack.back());
 }
 
@@ -717,6 +1254,7 @@ void BytecodeVM::execute_op(
 ) {
   const auto &val = frame.upvalues[op.index]->get();
   debug_print("GET_UPVALUE index={} value={}", op.index, val);
+  share(val);
   stack.push_back(val);
 }
 
@@ -7,6 +7,7 @@ import l3.location;
 import l3.runtime;
 
 import :builtins;
+import :scheduler;
 
 namespace {
 struct string_hash {
@@ -27,9 +28,16 @@ struct string_hash {
 
 export namespace l3::vm {
 
+class VmPool;
+
 class BytecodeVM {
 public:
   explicit BytecodeVM(bool debug_ = false);
+  BytecodeVM(const BytecodeVM &) = delete;
+  BytecodeVM(BytecodeVM &&) = delete;
+  BytecodeVM &operator=(const BytecodeVM &) = delete;
+  BytecodeVM &operator=(BytecodeVM &&) = delete;
+  ~BytecodeVM();
 
   runtime::StackValue heap_store(runtime::HeapData &&value);
 
@@ -39,6 +47,10 @@ public:
     return heap_store(runtime::HeapData{std::forward<T>(value)});
   }
 
+  [[nodiscard]] runtime::StackValue character(char character) {
+    return {&heap.character(character)};
+  }
+
   runtime::StackValue call_function(
       const runtime::StackValue &function,
       runtime::L3Args arguments,
@@ -48,24 +60,117 @@ public:
   std::size_t run_gc();
   void maybe_gc();
 
+  [[nodiscard]] const runtime::GcStats &get_gc_stats() const {
+    return gc_stats;
+  }
+
+  // Keeps the values of `values`, a vector of a builtin, alive while the
+  // builtin calls back into the VM: any call may collect, and the GC does not
+  // see C++ locals. Guards are scoped, and declared after their vector.
+  class RootGuard {
+  public:
+    RootGuard(BytecodeVM &vm, std::vector<runtime::StackValue> &values)
+        : vm{&vm} {
+      vm.scratch_roots.push_back(&values);
+    }
+    RootGuard(const RootGuard &) = delete;
+    RootGuard(RootGuard &&) = delete;
+    RootGuard &operator=(const RootGuard &) = delete;
+    RootGuard &operator=(RootGuard &&) = delete;
+    ~RootGuard() { vm->scratch_roots.pop_back(); }
+
+  private:
+    BytecodeVM *vm;
+  };
+
+  // Seeded once per VM, VMs on different threads never share it
+  [[nodiscard]] std::mt19937 &random_engine() { return random; }
+
+  // Calls `function` with each of `items` in worker VMs run by the task
+  // scheduler and returns the results in order. The function and the items
+  // are copied into the workers and the results back, see copy_in().
+  std::vector<runtime::StackValue> parallel_map(
+      const runtime::StackValue &function,
+      std::span<const runtime::StackValue> items
+  );
+  // Whether `function`, or a closure it captured, shares a `mut` variable
+  // with the function that created it. A copy of it in another VM would not
+  // see or make updates to the variable.
+  [[nodiscard]] static bool
+  captures_mutable(const runtime::StackValue &function);
+
+  // Starts `function(arguments...)` as a task in a VM of its own, run by the
+  // task scheduler, and returns a future of its result. The function and the
+  // arguments are copied into the task like those of parallel_map().
+  runtime::StackValue
+  spawn(const runtime::StackValue &function, runtime::L3Args arguments);
+  // Result of the task of `future`, copied into this VM, or the error it
+  // failed with. While the task is not done this thread runs other tasks
+  // instead of blocking. Tasks calling `await` from bytecode park instead,
+  // see park_await().
+  runtime::StackValue await(const runtime::Future &future);
+
+  // State of a higher-order builtin whose bytecode callback is driven from the
+  // dispatch loop. The frame holding it sits below the frame of the current
+  // callback call, OpReturn feeds it the result and calls the next element.
+  struct Intrinsic {
+    enum class Kind : std::uint8_t { Map, Filter, Count, Reduce, Fold };
+
+    Kind kind;
+    runtime::StackValue callback;
+    // Vector, range, packed array or set, re-read on every step as the
+    // callback may mutate it
+    runtime::StackValue source;
+    std::size_t index = 0;
+    // Element passed to the running callback call
+    runtime::StackValue current;
+    runtime::StackValue accumulator;
+    std::vector<runtime::StackValue> results;
+    std::int64_t count = 0;
+  };
+
   struct CallFrame {
     std::size_t chunk_id = 0;
     std::size_t ip = 0;
     std::size_t frame_pointer = 0;
     std::optional<location::Location> call_location;
-    std::optional<std::pair<runtime::BytecodeFunction, runtime::StackValue>>
-        closure;
-    std::vector<runtime::UpvalueCell *> upvalues;
+    // Closure being run, null at the top level and in intrinsic frames.
+    // `callee` holds the closure and keeps it alive.
+    const runtime::BytecodeFunction *closure = nullptr;
+    runtime::StackValue callee;
+    std::span<runtime::UpvalueCell *const> upvalues;
     std::unordered_map<std::size_t, runtime::UpvalueCell *> captured_locals;
+    std::optional<Intrinsic> intrinsic;
+    // Set on frames entered by OpCall, which run in the loop of their caller.
+    // OpReturn replaces the function and the arguments with the result, or
+    // drops them when the call does not keep it.
+    bool returns_to_call = false;
+    bool keep_return_value = false;
   };
 
-  void execute(bytecode::ProgramBytecode &program);
+  // The program is only read, closures are created from its prototypes. The
+  // VM holds on to it while values from the run may still refer to it.
+  void execute(bytecode::SharedProgram program);
+
+  // Drops everything left by previous runs, including a run that failed, and
+  // restores the builtins. The heap keeps the chunks it has grown, so the next
+  // run does not allocate them again.
+  void reset();
 
 private:
   std::optional<runtime::StackValue>
   resolve_global(std::string_view name) const;
   void define_global(std::string_view name, runtime::StackValue value);
+  [[nodiscard]] std::string_view global_name(std::size_t name_index) const;
+  // Resolves a global once per name constant, nullptr if undefined
+  runtime::StackValue *global_slot(std::size_t name_index);
+
+  void load_constants();
+  void release_constants();
 
+  runtime::StackValue call_builtin(
+      const runtime::BuiltinFunction &builtin, runtime::L3Args arguments
+  );
   runtime::StackValue call_function_impl(
       const runtime::StackValue &function,
       runtime::L3Args arguments,
@@ -85,6 +190,15 @@ private:
 
   void execute_loop(std::size_t target_frames);
 
+  // Runs map/filter/count/reduce/fold with a bytecode callback over a vector,
+  // range or packed array without re-entering the VM per element. Returns
+  // false when the call has to go through the builtin instead.
+  bool call_intrinsic(
+      const bytecode::OpCall &op, const runtime::StackValue &function
+  );
+  void advance_intrinsic();
+  void resume_intrinsic();
+
   void execute_op(const bytecode::OpReturn &op, CallFrame &);
   void execute_op(const bytecode::OpConstant &op, CallFrame &);
   void execute_op(const bytecode::OpPop &op, CallFrame &);
@@ -109,10 +223,16 @@ private:
   void execute_op(const bytecode::OpSetGlobal &op, CallFrame &);
   void execute_op(const bytecode::OpGetLocal &op, CallFrame &frame);
   void execute_op(const bytecode::OpSetLocal &op, CallFrame &frame);
+  void execute_op(const bytecode::OpAddAssign &op, CallFrame &frame);
   void execute_op(const bytecode::OpForLoop &op, CallFrame &frame);
   void execute_op(const bytecode::OpMakeArray &op, CallFrame &);
+  void execute_op(const bytecode::OpMakeDict &op, CallFrame &);
+  void execute_op(const bytecode::OpGetElement &op, CallFrame &);
   void execute_op(const bytecode::OpGetIndex &op, CallFrame &);
   void execute_op(const bytecode::OpSetIndex &op, CallFrame &);
+  void execute_op(const bytecode::OpMakeRecord &op, CallFrame &);
+  void execute_op(const bytecode::OpGetField &op, CallFrame &);
+  void execute_op(const bytecode::OpSetField &op, CallFrame &);
   void execute_op(const bytecode::OpCall &op, CallFrame &);
   void execute_op(const bytecode::OpClosure &op, CallFrame &frame);
   void execute_op(const bytecode::OpGetUpvalue &op, CallFrame &frame);
@@ -121,12 +241,56 @@ private:
   runtime::StackValue stack_pop();
   void stack_push(runtime::StackValue value);
 
+  // Copies of the cells of another VM made by one transfer, nullopt while
+  // the copy of a cell is being made
+  using Copies = std::unordered_map<
+      const runtime::HeapCell *,
+      std::optional<runtime::StackValue>>;
+  // Deep copy of `value`, a value of another VM running the same program,
+  // stored in this VM. Immutable data owned by the program, like constants,
+  // function prototypes and record shapes, is shared instead of copied.
+  runtime::StackValue
+  copy_in(const runtime::StackValue &value, Copies &copies);
+  // Runs the program of `source` and shares its task scheduler, for a VM
+  // running part of the work of `source`
+  void attach(const BytecodeVM &source);
+  // The scheduler of the VM that started this one, or one of its own
+  TaskScheduler &task_scheduler();
+
+  struct SpawnedTask;
+
+  // Parks the frames of a task calling `await` on a future that is not done:
+  // the dispatch loop returns, leaving the frames and the call on the stack,
+  // and the task resumes once the awaited one is done. Returns false when the
+  // call has to go through the builtin, outside tasks, when the future is
+  // done, or when a builtin or intrinsic between the task and the call runs
+  // a loop of its own.
+  bool park_await(
+      const bytecode::OpCall &op, const runtime::StackValue &function
+  );
+  // Completes the parked call with the result of the awaited task
+  void resume_await();
+  // Result of `task`, once done, copied into this VM
+  runtime::StackValue task_result(const SpawnedTask &task);
+
+  // Runs in a worker: calls `function` of `source` with each of `items` and
+  // leaves the results on the stack, after the function
+  void run_chunk(
+      const BytecodeVM &source,
+      const runtime::StackValue &function,
+      std::span<const runtime::StackValue> items
+  );
+
   template <typename... Args>
   void debug_print(std::format_string<Args...> fmt, Args &&...args);
 
   bool debug;
+  std::mt19937 random{std::random_device{}()};
   runtime::Heap heap;
   runtime::UpvalueStorage upvalues;
+  runtime::GcStats gc_stats;
+  std::vector<runtime::HeapCell *> gray_cells;
+  std::vector<runtime::UpvalueCell *> gray_upvalues;
   std::vector<runtime::StackValue> stack;
   std::unordered_map<
       std::string,
@@ -134,9 +298,78 @@ private:
       string_hash,
       std::equal_to<>>
       global_symbols;
+  // Vectors of the live RootGuards
+  std::vector<std::vector<runtime::StackValue> *> scratch_roots;
+  // Indexed like the builtin table, rooted so that reset() can restore
+  // builtins a program has reassigned
+  std::vector<runtime::StackValue> builtins;
 
   std::vector<CallFrame> frames;
-  bytecode::ProgramBytecode *current_program = nullptr;
+  std::vector<std::pair<const runtime::HeapCell *, Intrinsic::Kind>>
+      intrinsics;
+  const runtime::HeapCell *await_builtin = nullptr;
+  bytecode::SharedProgram shared_program;
+  // `shared_program` while it runs
+  const bytecode::ProgramBytecode *current_program = nullptr;
+  // Constants of the current program with strings replaced by their interned
+  // cells, interned cells from the GC heap are pinned until execution ends
+  std::vector<runtime::StackValue> constants;
+  std::vector<runtime::HeapCell *> pinned_constants;
+  std::vector<runtime::StackValue *> global_slots;
+  // Worker VMs of parallel_map(), created on first use
+  std::unique_ptr<VmPool> workers;
+  TaskScheduler *scheduler = nullptr;
+  // Queue of the thread running this VM, the jobs it creates go there
+  std::size_t scheduler_queue = 0;
+  // Set in the VMs of tasks, their awaits can park
+  bool parks_awaits = false;
+  // Task the frames are parked on, see park_await()
+  std::shared_ptr<SpawnedTask> awaiting;
+  bool awaiting_keeps_result = false;
+  // Set in the VM that created the scheduler. Declared last, destroying it
+  // first waits for the tasks left to finish.
+  std::unique_ptr<TaskScheduler> owned_scheduler;
+};
+
+// VMs kept around between runs. A VM shares no mutable state with any other,
+// so every VM handed out can run on its own thread while the others run.
+// Returned VMs are reset and keep their grown heap for the next run.
+class VmPool {
+public:
+  // A VM borrowed from the pool, given back when the lease is destroyed
+  class Lease {
+  public:
+    Lease(VmPool &pool, std::unique_ptr<BytecodeVM> vm)
+        : pool{&pool}, vm{std::move(vm)} {}
+    Lease(const Lease &) = delete;
+    Lease(Lease &&) noexcept = default;
+    Lease &operator=(const Lease &) = delete;
+    Lease &operator=(Lease &&) = delete;
+    ~Lease();
+
+    BytecodeVM &operator*() const { return *vm; }
+    BytecodeVM *operator->() const { return vm.get(); }
+
+  private:
+    VmPool *pool;
+    std::unique_ptr<BytecodeVM> vm;
+  };
+
+  explicit VmPool(bool debug_ = false) : debug{debug_} {}
+
+  // An idle VM, or a new one when all of them are in use
+  [[nodiscard]] Lease acquire();
+  // Runs `program` on a VM from the pool
+  void execute(bytecode::SharedProgram program);
+
+  [[nodiscard]] std::size_t idle_count() const;
+
+private:
+  void release(std::unique_ptr<BytecodeVM> vm);
+
+  bool debug;
+  mutable std::mutex mutex;
+  std::vector<std::unique_ptr<BytecodeVM>> idle;
 };
 
 } // namespace l3::vm
@@ -0,0 +1,40 @@
+module l3.vm;
+
+import std;
+
+namespace l3::vm {
+
+VmPool::Lease::~Lease() {
+  if (vm) {
+    pool->release(std::move(vm));
+  }
+}
+
+VmPool::Lease VmPool::acquire() {
+  {
+    const std::scoped_lock lock{mutex};
+    if (!idle.empty()) {
+      auto vm = std::move(idle.back());
+      idle.pop_back();
+      return {*this, std::move(vm)};
+    }
+  }
+  return {*this, std::make_unique<BytecodeVM>(debug)};
+}
+
+void VmPool::execute(bytecode::SharedProgram program) {
+  acquire()->execute(std::move(program));
+}
+
+std::size_t VmPool::idle_count() const {
+  const std::scoped_lock lock{mutex};
+  return idle.size();
+}
+
+void VmPool::release(std::unique_ptr<BytecodeVM> vm) {
+  vm->reset();
+  const std::scoped_lock lock{mutex};
+  idle.push_back(std::move(vm));
+}
+
+} // namespace l3::vm
@@ -106,7 +106,7 @@ std::string render_bytecode(const bytecode::ProgramBytecode &program) {
   return std::format("{}", program);
 }
 
-std::string run_and_capture_stdout(bytecode::ProgramBytecode &program) {
+std::string run_and_capture_stdout(const bytecode::SharedProgram &program) {
   struct StdoutRestore {
     int saved_fd = -1;
     ~StdoutRestore() {
@@ -272,7 +272,11 @@ SnapshotArtifacts build_artifacts(const SnapshotCase &test_case) {
   compiler.compile(*program_opt);
 
   artifacts.bytecode = render_bytecode(bytecode_program);
-  artifacts.output = run_and_capture_stdout(bytecode_program);
+  artifacts.output = run_and_capture_stdout(
+      std::make_shared<const bytecode::ProgramBytecode>(
+          std::move(bytecode_program)
+      )
+  );
 
   return artifacts;
 }
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include "run_program.hpp"
+
+import std;
+
+using l3::test::run;
+
+// Every callback collects, values a builtin holds between callbacks must be
+// rooted or they are freed while still in use
+TEST(GcRootsTest, KeepsValuesHeldBetweenCallbacks) {
+  run(R"(
+fn boxed(x)
+  __trigger_gc()
+  return [x, "item" + str(x)]
+end
+
+fn name(x)
+  __trigger_gc()
+  return "item" + str(x)
+end
+
+let pairs = collect(zip(imap(boxed, range(20)), imap(boxed, range(20))))
+assert(len(pairs) == 20, "zip", len(pairs))
+assert(pairs[7] == [[7, "item7"], [7, "item7"]], "zip", pairs[7])
+
+let mapped = map(boxed, iter(range(20)))
+assert(mapped[19] == [19, "item19"], "map", mapped[19])
+
+let kept = filter(fn(item) return item[0] % 2 == 0 end, imap(boxed, range(20)))
+assert(kept[9] == [18, "item18"], "filter", kept[9])
+
+let joined = reduce(fn(a, b) return a + b end, imap(name, range(3)))
+assert(joined == "item0item1item2", "reduce", joined)
+let folded = fold(fn(a, b) return a + [b] end, [], imap(name, range(3)))
+assert(folded == ["item0", "item1", "item2"], "fold", folded)
+
+let sorted = sort(imap(name, [2, 0, 1]))
+assert(sorted == ["item0", "item1", "item2"], "sort", sorted)
+assert(len(set(imap(name, [1, 1, 2]))) == 2, "set")
+)");
+}
+
+TEST(GcRootsTest, KeepsSortKeysAlive) {
+  run(R"(
+fn key(x)
+  __trigger_gc()
+  return "key" + str(9 - x)
+end
+
+let sorted = sort_by(key, imap(fn(x) return [x] end, range(5)))
+assert(sorted == [[4], [3], [2], [1], [0]], "sort_by", sorted)
+)");
+}
+
+TEST(GcRootsTest, KeepsMappedGridCellsAlive) {
+  run(R"(
+fn cell(x)
+  __trigger_gc()
+  return "cell" + str(x)
+end
+
+let g = gmap(cell, grid(2, 3, 1))
+assert(g[1][2] == "cell1", "gmap", g[1][2])
+)");
+}
+
+TEST(GcRootsTest, KeepsParallelMapItemsAlive) {
+  run(R"(
+fn boxed(x)
+  __trigger_gc()
+  return [x]
+end
+
+let lengths = pmap(len, imap(boxed, range(10)))
+assert(lengths == map(fn(x) return 1 end, range(10)), "pmap", lengths)
+let kept = pfilter(fn(item) return item[0] > 6 end, imap(boxed, range(10)))
+assert(kept == [[7], [8], [9]], "pfilter", kept)
+)");
+}
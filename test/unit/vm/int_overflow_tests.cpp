@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include "run_program.hpp"
+
+import std;
+
+using l3::test::run;
+using l3::test::run_error;
+
+TEST(IntOverflowTest, SumsLongRangesExactly) {
+  run(R"(
+# count * (count - 1) is past the int range, the sum is not
+let total = sum(range(0, 3100000000))
+assert(total == 4804999998450000000, "sum", total)
+let down = sum(range(3100000000, 0, -1))
+assert(down == 4805000001550000000, "sum", down)
+)");
+}
+
+TEST(IntOverflowTest, PromotesRangeSumsPastTheIntRange) {
+  run(R"(
+let up = sum(range(0, 5000000000))
+assert(str(up) == "12499999997500000000", "sum", up)
+let down = sum(range(0, -5000000000, -1))
+assert(str(down) == "-12499999997500000000", "sum", down)
+)");
+}
+
+TEST(IntOverflowTest, PromotesElementwiseOverflows) {
+  run(R"(
+let added = vadd(array([9223372036854775807, 1]), 1)
+assert(str(added) == "[9223372036854775808, 2]", "vadd", added)
+let subtracted = vsub([-9223372036854775807, 5], [2, 3])
+assert(str(subtracted) == "[-9223372036854775809, 2]", "vsub", subtracted)
+let multiplied = vmul(range(3000000000, 3000000002), 4000000000)
+let products = "[12000000000000000000, 12000000004000000000]"
+assert(str(multiplied) == products, "vmul", multiplied)
+assert(vadd([1, 2], [3, 4]) == [4, 6], "packed")
+)");
+}
+
+TEST(IntOverflowTest, ReadsLiteralsPastTheIntRange) {
+  run(R"(
+let two = 2
+let big = 18446744073709551616
+assert(str(big) == "18446744073709551616", "literal", big)
+assert(big == two ^ 64, "power", big)
+assert(-9223372036854775808 == -9223372036854775807 - 1, "min")
+
+# Keys compare by value, the computed BigInt is a different cell
+let counts = {big: 1}
+counts[two ^ 64] = 2
+assert(counts[big] == 2 and len(counts) == 1, "dict", counts)
+assert(len(set([big, two ^ 64, -big])) == 2, "set")
+)");
+}
+
+TEST(IntOverflowTest, MeasuresRangesSpanningTheIntRange) {
+  run(R"(
+let min = -9223372036854775807 - 1
+let max = 9223372036854775807
+let up = range(0, max)
+assert(len(up) == max, "length", len(up))
+assert(up[len(up) - 1] == max - 1, "last", up[len(up) - 1])
+let wide = range(min, max, 4611686018427387904)
+assert(len(wide) == 4, "length", len(wide))
+assert(wide[3] == 4611686018427387904, "last", wide[3])
+let down = range(max, min, min)
+assert(len(down) == 2, "length", len(down))
+assert(down[1] == -1, "last", down[1])
+)");
+  EXPECT_EQ(
+      run_error("range(-1, 9223372036854775807)"),
+      "range() has more elements than an int can count"
+  );
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include "run_program.hpp"
+
+import std;
+
+using l3::test::run;
+using l3::test::run_error;
+
+TEST(ParallelMapTest, MatchesSerialMap) {
+  run(R"(
+record Item(name, weight)
+
+fn score(item)
+  let mut total = 0
+  for i in 0..item.weight do
+    total += i
+  end
+  return [item.name, total]
+end
+
+let items = map(fn(i) return Item("item" + str(i), i) end, range(200))
+assert(pmap(score, items) == map(score, items), "pmap")
+let even = pfilter(fn(item) return item.weight % 2 == 0 end, items)
+assert(len(even) == 100, "pfilter", len(even))
+assert(even[1] == Item("item2", 2), "pfilter", even[1])
+assert(pmap(score, []) == [], "empty")
+)");
+}
+
+TEST(ParallelMapTest, CopiesCapturedValues) {
+  run(R"(
+let offset = 10
+let table = {"a": 1, "b": 2}
+
+fn lookup(key)
+  return table[key] + offset
+end
+
+fn fact(n)
+  if n <= 1 then
+    return 1
+  end
+  return n * fact(n - 1)
+end
+
+assert(pmap(lookup, ["a", "b", "a"]) == [11, 12, 11], "lookup")
+assert(pmap(fact, range(1, 6)) == [1, 2, 6, 24, 120], "fact")
+
+fn add(a, b)
+  return a + b
+end
+
+assert(pmap(add(5), [1, 2]) == [6, 7], "partial")
+)");
+}
+
+TEST(ParallelMapTest, RunsClosuresOverMutableVariablesSerially) {
+  run(R"(
+let mut calls = 0
+
+fn counted(x)
+  calls += 1
+  return x * 2
+end
+
+assert(pmap(counted, [1, 2, 3]) == [2, 4, 6], "pmap")
+assert(pfilter(counted, [0, 1]) == [1], "pfilter")
+assert(calls == 5, "calls", calls)
+)");
+}
+
+TEST(ParallelMapTest, ReportsValuesThatCannotBeCopied) {
+  EXPECT_NE(
+      run_error(R"(
+let mut total = 0
+
+fn add(x)
+  total += x
+  return total
+end
+
+pmap(len, [add])
+)")
+          .find("add captures a mut variable"),
+      std::string::npos
+  );
+  EXPECT_NE(
+      run_error("pmap(id, [iter(range(3))])").find("an iterator cannot"),
+      std::string::npos
+  );
+}
+
+TEST(ParallelMapTest, RethrowsErrorsOfWorkers) {
+  EXPECT_EQ(
+      run_error(R"(pmap(fn(x) return error("bad item", x) end, [1]))"),
+      "bad item 1"
+  );
+}
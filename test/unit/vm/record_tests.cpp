@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include "run_program.hpp"
+
+import std;
+
+using l3::test::run;
+using l3::test::run_error;
+
+TEST(RecordTest, PassesConstructorsAsValues) {
+  run(R"(
+record Point(x, y)
+record Box(value)
+
+let boxes = map(Box, [1, 2])
+assert(boxes == [Box(1), Box(2)], "map", boxes)
+let on_axis = Point(0)
+assert(on_axis(7) == Point(0, 7), "partial", on_axis(7))
+let points = map(Point(3), [4, 5])
+assert(points == [Point(3, 4), Point(3, 5)], "map partial", points)
+let make = Point
+assert(make(1, 2).y == 2, "value")
+)");
+}
+
+TEST(RecordTest, ScopesDeclarationsToTheirBlock) {
+  run(R"(
+fn make()
+  record Pair(first, second)
+  return Pair(1, 2)
+end
+
+let Pair = fn(a, b) return a + b end
+assert(Pair(1, 2) == 3, "outer", Pair(1, 2))
+assert(make().second == 2, "inner")
+)");
+  // Outside its block the record name is an unknown global
+  const auto error = run_error(R"(
+fn make()
+  record Pair(first, second)
+  return Pair(1, 2)
+end
+Pair(1, 2)
+)");
+  EXPECT_NE(error.find("Pair"), std::string::npos) << error;
+}
+
+TEST(RecordTest, VariablesShadowRecords) {
+  run(R"(
+record Point(x, y)
+
+fn apply(Point)
+  return Point(1, 2)
+end
+assert(apply(fn(x, y) return x * y end) == 2, "parameter")
+
+let Point = fn(x, y) return x - y end
+assert(Point(1, 2) == -1, "local")
+)");
+}
+
+TEST(RecordTest, InnerRecordsShadowOuterOnes) {
+  run(R"(
+record Point(x, y)
+
+fn flat()
+  record Point(x)
+  return Point(1)
+end
+assert(flat().x == 1, "inner")
+assert(Point(1, 2).y == 2, "outer")
+)");
+}
@@ -0,0 +1,45 @@
+#include "run_program.hpp"
+
+import std;
+
+import l3.ast;
+import l3.bytecode;
+import l3.compiler;
+import l3.runtime;
+import l3.vm;
+
+namespace l3::test {
+
+bytecode::SharedProgram compile(const std::string &source) {
+  std::istringstream input{source};
+  lexer::L3Lexer lexer(input, false);
+
+  auto program = ast::Program{};
+  parser::L3Parser parser(lexer, "<test>", false, program);
+  if (parser.parse() != 0) {
+    throw std::runtime_error("failed to parse test program");
+  }
+
+  bytecode::ProgramBytecode program_bytecode;
+  compiler::Compiler compiler{program_bytecode};
+  compiler.compile(program);
+  return std::make_shared<const bytecode::ProgramBytecode>(
+      std::move(program_bytecode)
+  );
+}
+
+void run(const std::string &source) {
+  vm::BytecodeVM vm;
+  vm.execute(compile(source));
+}
+
+std::string run_error(const std::string &source) {
+  try {
+    run(source);
+  } catch (const runtime::RuntimeError &error) {
+    return error.what();
+  }
+  return {};
+}
+
+} // namespace l3::test
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <lexer/lexer.hpp>
+
+import std;
+
+import l3.bytecode;
+
+// Compiling and running l3 source for the VM tests
+namespace l3::test {
+
+// Parses and compiles `source`, throwing if it does not parse
+bytecode::SharedProgram compile(const std::string &source);
+
+// Runs `source` on a new VM
+void run(const std::string &source);
+
+// Message of the runtime error raised by running `source`, empty if it ran
+std::string run_error(const std::string &source);
+
+} // namespace l3::test
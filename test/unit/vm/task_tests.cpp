@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+
+#include "run_program.hpp"
+
+import std;
+
+using l3::test::run;
+using l3::test::run_error;
+
+TEST(TaskTest, AwaitsResultsOfSpawnedFunctions) {
+  run(R"(
+fn fib(n)
+  if n < 2 then
+    return n
+  end
+  return fib(n - 1) + fib(n - 2)
+end
+
+let futures = map(fn(n) return spawn(fib, n) end, range(15))
+assert(str(futures[0]) == "<future>", "future", futures[0])
+assert(map(await, futures) == map(fib, range(15)), "results")
+
+let table = {"a": [1, 2]}
+let copied = await(spawn(fn(t) return t["a"] end, table))
+assert(copied == [1, 2], "copied", copied)
+)");
+}
+
+TEST(TaskTest, TasksSpawnAndAwaitTasks) {
+  run(R"(
+fn sum_tree(depth)
+  if depth == 0 then
+    return 1
+  end
+  let left = spawn(sum_tree, depth - 1)
+  let right = spawn(sum_tree, depth - 1)
+  return await(left) + await(right)
+end
+
+assert(await(spawn(sum_tree, 6)) == 64, "tree")
+
+let first = spawn(fn(x) return x * 2 end, 21)
+let second = spawn(fn(f) return await(f) + 1 end, first)
+assert(await(second) == 43, "second")
+assert(await(first) == 42, "awaited twice")
+assert(await(spawn(pmap, fn(x) return x + 1 end, [1, 2])) == [2, 3], "pmap")
+)");
+}
+
+TEST(TaskTest, ParksAwaitsInNestedCalls) {
+  run(R"(
+fn slow(n)
+  let mut total = 0
+  for i in 0..n do
+    total += i
+  end
+  return total
+end
+
+fn add_awaited(first, second)
+  await(first)
+  return await(first) + await(second)
+end
+
+fn waiter(shared, n)
+  return add_awaited(shared, spawn(slow, n))
+end
+
+let shared = spawn(slow, 200000)
+let futures = map(fn(n) return spawn(waiter, shared, n) end, range(64))
+let expected = map(fn(n) return slow(200000) + slow(n) end, range(64))
+assert(map(await, futures) == expected, "results")
+)");
+  EXPECT_EQ(
+      run_error(R"(
+let inner = spawn(fn(x) return error("inner task", x) end, 2)
+await(spawn(fn(f) return [await(f)] end, inner))
+)"),
+      "inner task 2"
+  );
+}
+
+TEST(TaskTest, ReportsErrors) {
+  EXPECT_EQ(
+      run_error(R"(await(spawn(fn(x) return error("bad task", x) end, 1)))"),
+      "bad task 1"
+  );
+  EXPECT_NE(
+      run_error(R"(
+let mut total = 0
+
+fn add(x)
+  total += x
+  return total
+end
+
+spawn(add, 1)
+)")
+          .find("add captures a mut variable"),
+      std::string::npos
+  );
+  EXPECT_EQ(run_error("await(1)"), "await() argument must be a future");
+  EXPECT_EQ(
+      run_error("spawn(1)"), "spawn() first argument must be a function"
+  );
+}
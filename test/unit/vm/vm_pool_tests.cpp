@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+
+#include "run_program.hpp"
+
+import std;
+
+import l3.runtime;
+import l3.vm;
+
+using namespace l3;
+using l3::test::compile;
+
+namespace {
+
+// Closures, string constants and concatenation, the allocator and the random
+// generator: everything a VM keeps to itself and that used to be shared
+const std::string kWorkload = R"(
+fn make_adder(n)
+  return fn(x)
+    return x + n
+  end
+end
+
+let mut total = 0
+let mut text = ""
+for i in 0..500 do
+  let add = make_adder(i)
+  total += add(1)
+  text = text + "ab"
+end
+assert(total == 125250, "total", total)
+assert(len(text) == 1000, "length", len(text))
+
+let roll = random(1, 6)
+assert(1 <= roll <= 6, "roll", roll)
+__trigger_gc()
+)";
+
+} // namespace
+
+class VmPoolTest : public ::testing::Test {
+protected:
+  vm::VmPool pool;
+};
+
+TEST_F(VmPoolTest, ReusesReturnedVm) {
+  const auto program = compile(kWorkload);
+
+  const vm::BytecodeVM *first = nullptr;
+  {
+    auto vm = pool.acquire();
+    vm->execute(program);
+    first = &*vm;
+  }
+  EXPECT_EQ(pool.idle_count(), 1UZ);
+
+  auto vm = pool.acquire();
+  EXPECT_EQ(&*vm, first);
+  EXPECT_EQ(pool.idle_count(), 0UZ);
+  vm->execute(program);
+}
+
+TEST_F(VmPoolTest, ReturnsVmAfterRuntimeError) {
+  EXPECT_THROW(
+      pool.execute(compile(R"(error("failed"))")), runtime::RuntimeError
+  );
+  EXPECT_EQ(pool.idle_count(), 1UZ);
+
+  pool.execute(compile(kWorkload));
+  EXPECT_EQ(pool.idle_count(), 1UZ);
+}
+
+TEST_F(VmPoolTest, ResetRestoresReassignedBuiltins) {
+  pool.execute(compile("len = 0"));
+  pool.execute(compile(R"(assert(len("abc") == 3))"));
+}
+
+TEST_F(VmPoolTest, RunsHundredsOfIsolatesConcurrently) {
+  constexpr std::size_t kIsolates = 512;
+  const auto program = compile(kWorkload);
+  const auto thread_count =
+      std::clamp(std::thread::hardware_concurrency(), 2U, 16U);
+
+  std::atomic<std::size_t> next = 0;
+  std::atomic<std::size_t> completed = 0;
+  std::atomic<std::size_t> failures = 0;
+  {
+    std::vector<std::jthread> threads;
+    for (unsigned i = 0; i < thread_count; ++i) {
+      threads.emplace_back([&] {
+        while (next++ < kIsolates) {
+          try {
+            pool.execute(program);
+            ++completed;
+          } catch (const std::exception &) {
+            ++failures;
+          }
+        }
+      });
+    }
+  }
+
+  EXPECT_EQ(failures.load(), 0UZ);
+  EXPECT_EQ(completed.load(), kIsolates);
+  EXPECT_LE(pool.idle_count(), thread_count);
+}
+
+TEST(BytecodeVmTest, IsolatesOnSeparateThreadsShareOnlyTheProgram) {
+  constexpr std::size_t kIsolates = 256;
+  const auto program = compile(kWorkload);
+
+  std::atomic<std::size_t> failures = 0;
+  {
+    std::vector<std::jthread> threads;
+    threads.reserve(kIsolates);
+    for (std::size_t i = 0; i < kIsolates; ++i) {
+      threads.emplace_back([&] {
+        try {
+          vm::BytecodeVM vm;
+          vm.execute(program);
+        } catch (const std::exception &) {
+          ++failures;
+        }
+      });
+    }
+  }
+
+  EXPECT_EQ(failures.load(), 0UZ);
+}
+
+TEST(BytecodeVmTest, IsolatesConcatenateOntoLongStringConstants) {
+  constexpr std::size_t kIsolates = 64;
+  // Folded into one constant, long enough to be built into a shared buffer
+  const auto program = compile(std::format(
+      R"(
+let prefix = "{}" + "a"
+for i in 0..200 do
+  let text = prefix + str(i) * 80
+  assert(len(text) == 131 + len(str(i)) * 80, "length", len(text))
+  assert(text[130] == "a", "prefix", text[130])
+end
+assert(len(prefix) == 131, "constant", len(prefix))
+)",
+      std::string(130, 'x')
+  ));
+
+  std::atomic<std::size_t> failures = 0;
+  {
+    std::vector<std::jthread> threads;
+    threads.reserve(kIsolates);
+    for (std::size_t i = 0; i < kIsolates; ++i) {
+      threads.emplace_back([&] {
+        try {
+          vm::BytecodeVM vm;
+          vm.execute(program);
+        } catch (const std::exception &) {
+          ++failures;
+        }
+      });
+    }
+  }
+
+  EXPECT_EQ(failures.load(), 0UZ);
+}